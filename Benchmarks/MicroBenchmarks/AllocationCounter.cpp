@@ -0,0 +1,55 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+    std::atomic<size_t> allocations{ 0 };
+    std::atomic<size_t> bytesInUse{ 0 };
+
+    // Each block carries its requested size in front so delete can
+    // subtract it; the header keeps max_align_t alignment
+    constexpr size_t HEADER = alignof(std::max_align_t);
+
+} // namespace
+
+size_t AllocationCounter::count()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+size_t AllocationCounter::liveBytes()
+{
+    return bytesInUse.load(std::memory_order_relaxed);
+}
+
+// Replacing the plain forms is enough: the array and nothrow forms
+// forward to them by default
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytesInUse.fetch_add(size, std::memory_order_relaxed);
+
+    if (char* block = static_cast<char*>(std::malloc(size + HEADER))) {
+        *reinterpret_cast<std::size_t*>(block) = size;
+        return block + HEADER;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    if (!memory)
+        return;
+
+    char* block = static_cast<char*>(memory) - HEADER;
+    bytesInUse.fetch_sub(*reinterpret_cast<std::size_t*>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    operator delete(memory);
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+
+// Counts every global operator new in the benchmark process, and the bytes
+// still allocated, so a benchmark can report allocations or memory per item:
+//
+//     size_t before = AllocationCounter::count();
+//     for (auto _ : state) { ... }
+//     state.counters["allocs_per_row"] = AllocationCounter::perIteration(state, before);
+namespace AllocationCounter {
+
+    size_t count();
+    size_t liveBytes(); // requested bytes not yet freed, excluding allocator overhead
+
+    template <typename State>
+    double perIteration(const State& state, size_t before)
+    {
+        return state.iterations() ? double(count() - before) / state.iterations() : 0.0;
+    }
+
+} // namespace AllocationCounter
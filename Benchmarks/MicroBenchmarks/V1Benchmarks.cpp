@@ -0,0 +1,304 @@
+// V1Benchmarks.cpp : micro-benchmarks for the V1 validation and storage
+// functions. V1 and V2 both define a global User, so each version gets its
+// own benchmark executable.
+
+#include "AllocationCounter.h"
+#include "../../V1_Foundations_UserLoginSystem/header_functions.h"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::vector<std::string> EMAILS = {
+    "alice@example.com", "bob.smith@mail.example.org", "not-an-email",
+    "trailing.dot@example.", "@missing-local.com", "carol+tag@sub.domain.co"
+};
+
+const std::vector<std::string> USERNAMES = {
+    "alice", "bob_smith_42", "x", "has space", "_leading", "averyveryverylongusername"
+};
+
+// V1 keeps its table in the working directory, so every fixture runs in a
+// scratch directory of its own
+void EnterScratchDirectory()
+{
+    static const std::filesystem::path scratch =
+        std::filesystem::temp_directory_path() / "cpp-evolution-v1-bench";
+
+    std::filesystem::create_directories(scratch);
+    std::filesystem::current_path(scratch);
+}
+
+// Replace the process-wide index with a fresh table of the given size
+void LoadTable(int rows)
+{
+    EnterScratchDirectory();
+
+    UserLog& log = GetUserLog();
+    if (log.compactor.joinable())
+        log.compactor.join();
+    log.out.close();
+    log.entries = 0;
+
+    remove("users.log");
+    remove("users.log.compacting");
+    remove("temp.txt");
+
+    std::vector<User> users(rows);
+    for (int i = 0; i < rows; ++i)
+    {
+        User& user = users[i];
+        user.id = i + 1;
+        user.username = "user" + std::to_string(user.id);
+        user.email = user.username + "@example.com";
+        user.password = "Passw0rd!";
+        user.createdAt = 1704110400; // 2024-01-01 12:00:00
+        user.lastLogin = user.createdAt;
+    }
+
+    WriteSnapshot(users);
+
+    UserIndex& index = GetUserIndex();
+    index = UserIndex();
+    LoadUserIndex(index);
+}
+
+// GetCurrentDateTime as it was before the per-second cache, kept as the
+// baseline for BM_V1_GetCurrentDateTime
+std::string LegacyCurrentDateTime()
+{
+    time_t now = time(0);
+    tm ltm;
+
+#ifdef _WIN32
+    localtime_s(&ltm, &now);
+#else
+    localtime_r(&now, &ltm);
+#endif
+
+    std::ostringstream oss;
+    oss << std::setfill('0')
+        << std::setw(4) << 1900 + ltm.tm_year << "-"
+        << std::setw(2) << 1 + ltm.tm_mon << "-"
+        << std::setw(2) << ltm.tm_mday << " "
+        << std::setw(2) << ltm.tm_hour << ":"
+        << std::setw(2) << ltm.tm_min << ":"
+        << std::setw(2) << ltm.tm_sec;
+
+    return oss.str();
+}
+
+} // namespace
+
+/*
+* ==================== Validation ====================
+*/
+
+static void BM_V1_IsValidEmail(benchmark::State& state)
+{
+    size_t i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(IsValidEmail(EMAILS[i++ % EMAILS.size()]));
+}
+BENCHMARK(BM_V1_IsValidEmail);
+
+static void BM_V1_IsValidUsername(benchmark::State& state)
+{
+    size_t i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(IsValidUsername(USERNAMES[i++ % USERNAMES.size()]));
+}
+BENCHMARK(BM_V1_IsValidUsername);
+
+/*
+* ==================== Record parsing ====================
+*/
+
+static void BM_V1_ParseUserRecord(benchmark::State& state)
+{
+    const std::string line = "42,alice@example.com,alice_w,Passw0rd!,"
+        "2024-01-01 12:00:00,2024-01-02 08:30:00";
+
+    User user;
+    ParseUserRecord(line, user); // size the reused strings once
+
+    const size_t before = AllocationCounter::count();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(ParseUserRecord(line, user));
+
+    state.counters["allocs_per_row"] = AllocationCounter::perIteration(state, before);
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+BENCHMARK(BM_V1_ParseUserRecord);
+
+/*
+* ==================== Storage ====================
+*/
+
+static void BM_V1_GetLastId(benchmark::State& state)
+{
+    LoadTable(static_cast<int>(state.range(0)));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(GetLastId());
+}
+BENCHMARK(BM_V1_GetLastId)->Arg(1000)->Arg(100000)->Arg(1000000);
+
+static void BM_V1_RewriteUser(benchmark::State& state)
+{
+    const int rows = static_cast<int>(state.range(0));
+    LoadTable(rows);
+
+    User user;
+    FindUserByUsername("user" + std::to_string(rows / 2), user);
+
+    int version = 0;
+    for (auto _ : state)
+    {
+        user.email = "user" + std::to_string(version++) + "@rewrite.example.com";
+        RewriteUser(user);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_V1_RewriteUser)->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+
+// Lookups with no other instance writing: no users.lock, no stat
+static void BM_V1_FindUserByUsername(benchmark::State& state)
+{
+    const int rows = static_cast<int>(state.range(0));
+    LoadTable(rows);
+
+    User user;
+    int i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(FindUserByUsername("user" + std::to_string(i++ % rows + 1), user));
+}
+BENCHMARK(BM_V1_FindUserByUsername)->Arg(100000);
+
+// Startup cost of a second instance. Arg 1 copies the image another
+// instance published to shared memory; arg 0 finds it stale and parses.
+static void BM_V1_LoadUserIndex(benchmark::State& state)
+{
+    const int rows = static_cast<int>(state.range(0));
+    const bool attach = state.range(1) != 0;
+    LoadTable(rows);
+
+    UserIndex& index = GetUserIndex();
+
+    for (auto _ : state)
+    {
+        if (!attach)
+        {
+            state.PauseTiming();
+            WriteSnapshot(SnapshotUsers());
+            state.ResumeTiming();
+        }
+
+        index = UserIndex();
+        LoadUserIndex(index);
+    }
+
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_V1_LoadUserIndex)->ArgNames({ "rows", "attach" })
+    ->Args({ 100000, 0 })->Args({ 100000, 1 })->Args({ 1000000, 0 })->Args({ 1000000, 1 })
+    ->Unit(benchmark::kMillisecond);
+
+/*
+* ==================== Bulk import / export ====================
+*/
+
+// Rows/sec for a CSV of the given size loaded into an empty table
+static void BM_V1_ImportUsers(benchmark::State& state)
+{
+    const int rows = static_cast<int>(state.range(0));
+    EnterScratchDirectory();
+
+    {
+        std::ofstream csv("import.csv", std::ios::trunc);
+        for (int i = 1; i <= rows; ++i)
+        {
+            csv << i << ",import" << i << "@example.com,import" << i
+                << ",Passw0rd!,2024-01-01 12:00:00,2024-01-01 12:00:00\n";
+        }
+    }
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        LoadTable(0);
+        state.ResumeTiming();
+
+        ImportReport report;
+        ImportUsers("import.csv", report);
+        benchmark::DoNotOptimize(report.imported);
+    }
+
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_V1_ImportUsers)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_V1_ExportUsers(benchmark::State& state)
+{
+    const int rows = static_cast<int>(state.range(0));
+    LoadTable(rows);
+
+    for (auto _ : state)
+    {
+        size_t exported = 0;
+        ExportUsers("export.csv", exported);
+        benchmark::DoNotOptimize(exported);
+    }
+
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_V1_ExportUsers)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+/*
+* ==================== Timestamps ====================
+*/
+
+static void BM_V1_GetCurrentDateTimeLegacy(benchmark::State& state)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(LegacyCurrentDateTime());
+}
+BENCHMARK(BM_V1_GetCurrentDateTimeLegacy)->ThreadRange(1, 8);
+
+static void BM_V1_GetCurrentDateTime(benchmark::State& state)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(GetCurrentDateTime());
+}
+BENCHMARK(BM_V1_GetCurrentDateTime)->ThreadRange(1, 8);
+
+/*
+* ==================== Memory ====================
+*/
+
+// Heap bytes held by the index per cached user
+static void BM_V1_IndexMemory(benchmark::State& state)
+{
+    const int rows = static_cast<int>(state.range(0));
+    double bytesPerUser = 0;
+
+    for (auto _ : state)
+    {
+        LoadTable(0);
+        const size_t before = AllocationCounter::liveBytes();
+
+        LoadTable(rows);
+        bytesPerUser = double(AllocationCounter::liveBytes() - before) / rows;
+    }
+
+    state.counters["bytes_per_user"] = bytesPerUser;
+}
+BENCHMARK(BM_V1_IndexMemory)->Arg(100000)->Iterations(1)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,300 @@
+// V2Benchmarks.cpp : micro-benchmarks for the V2 Validator, User
+// serialization and UserRepository hot paths.
+
+#include "AllocationCounter.h"
+#include "../../V2_Guardian_OOP Refactor/include/CharClass.h"
+#include "../../V2_Guardian_OOP Refactor/include/CsvTokenizer.h"
+#include "../../V2_Guardian_OOP Refactor/include/LoginThrottle.h"
+#include "../../V2_Guardian_OOP Refactor/include/PasswordHasher.h"
+#include "../../V2_Guardian_OOP Refactor/include/User.h"
+#include "../../V2_Guardian_OOP Refactor/include/UserRecordFile.h"
+#include "../../V2_Guardian_OOP Refactor/include/UserRepository.h"
+#include "../../V2_Guardian_OOP Refactor/include/Validator.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::vector<std::string> EMAILS = {
+    "alice@example.com", "bob.smith@mail.example.org", "not-an-email",
+    "trailing.dot@example.", "@missing-local.com", "carol+tag@sub.domain.co"
+};
+
+const std::vector<std::string> PASSWORDS = {
+    "Passw0rd!", "short1!", "alllowercase1!", "NoDigitsHere!",
+    "Str0ng#Enough", "With Space1!"
+};
+
+const std::string RECORD = "42,alice_w,$argon2id$v=19$m=19456,t=2,p=1$c2FsdA$dGFn,"
+    "alice@example.com,2024-01-01 12:00:00";
+
+// A fresh repository of the given size in a scratch directory
+std::unique_ptr<UserRepository> MakeRepository(int rows,
+    GroupCommitOptions commitOptions = GroupCommitOptions())
+{
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / "cpp-evolution-v2-bench";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    std::vector<User> users;
+    users.reserve(rows);
+    for (int i = 1; i <= rows; ++i) {
+        const std::string name = "user" + std::to_string(i);
+        users.emplace_back(i, name, "Passw0rd!", name + "@example.com", "2024-01-01 12:00:00");
+    }
+
+    const std::string path = (dir / "users.dat").string();
+    UserRecordFile::write(path, users);
+    return std::make_unique<UserRepository>(path, commitOptions);
+}
+
+} // namespace
+
+// ==================== Validator ====================
+
+static void BM_V2_IsValidEmail(benchmark::State& state)
+{
+    size_t i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(Validator::isValidEmail(EMAILS[i++ % EMAILS.size()]));
+}
+BENCHMARK(BM_V2_IsValidEmail);
+
+static void BM_V2_IsValidPassword(benchmark::State& state)
+{
+    size_t i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(Validator::isValidPassword(PASSWORDS[i++ % PASSWORDS.size()]));
+}
+BENCHMARK(BM_V2_IsValidPassword);
+
+// Email column of 10K rows, once per kernel (0 scalar, 1 SSE4.2, 2 AVX2)
+static void BM_V2_ValidateColumn(benchmark::State& state)
+{
+    const CharClass::Kernel kernel = static_cast<CharClass::Kernel>(state.range(0));
+    if (kernel > CharClass::bestSupportedKernel()) {
+        state.SkipWithError("kernel not supported on this CPU");
+        return;
+    }
+
+    std::vector<std::string> column;
+    for (int i = 0; i < 10000; ++i)
+        column.push_back(EMAILS[i % EMAILS.size()] + std::to_string(i));
+
+    const std::vector<std::string_view> views(column.begin(), column.end());
+    std::vector<uint8_t> valid;
+
+    CharClass::setKernel(kernel);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(Validator::validateColumn(Validator::Field::EMAIL, views, valid));
+    CharClass::setKernel(CharClass::bestSupportedKernel());
+
+    state.SetItemsProcessed(state.iterations() * views.size());
+}
+BENCHMARK(BM_V2_ValidateColumn)->Arg(CharClass::SCALAR)->Arg(CharClass::SSE42)->Arg(CharClass::AVX2);
+
+// ==================== PasswordHasher ====================
+
+// One hash at the default cost (19 MiB, 2 passes, 1 lane), once per
+// block-mixing kernel (0 scalar, 1 SSE2, 2 AVX2)
+static void BM_V2_PasswordHash(benchmark::State& state)
+{
+    const PasswordHasher::Kernel kernel = static_cast<PasswordHasher::Kernel>(state.range(0));
+    if (kernel > PasswordHasher::bestSupportedKernel()) {
+        state.SkipWithError("kernel not supported on this CPU");
+        return;
+    }
+
+    const std::vector<uint8_t> salt(PasswordHasher::SALT_LENGTH, 0x5A);
+    const PasswordHasher::Params params;
+
+    PasswordHasher::setKernel(kernel);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(PasswordHasher::argon2id("Passw0rd!", salt, params));
+    PasswordHasher::setKernel(PasswordHasher::bestSupportedKernel());
+}
+BENCHMARK(BM_V2_PasswordHash)->Arg(PasswordHasher::SCALAR)->Arg(PasswordHasher::SSE2)->Arg(PasswordHasher::AVX2)
+    ->Unit(benchmark::kMillisecond);
+
+// ==================== User serialization ====================
+
+static void BM_V2_UserFromFileString(benchmark::State& state)
+{
+    const size_t before = AllocationCounter::count();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(User::fromFileString(RECORD));
+
+    state.counters["allocs_per_row"] = AllocationCounter::perIteration(state, before);
+    state.SetBytesProcessed(state.iterations() * RECORD.size());
+}
+BENCHMARK(BM_V2_UserFromFileString);
+
+// Tokenizing alone: arg 0 is a plain record, arg 1 has quoted fields
+static void BM_V2_CsvTokenize(benchmark::State& state)
+{
+    const std::string line = state.range(0) == 0 ? RECORD
+        : "42,\"smith, alice\",\"pa\"\"ss,word\",alice@example.com,2024-01-01 12:00:00";
+
+    CsvTokenizer fields;
+    fields.tokenize(line); // size the reused buffer once
+
+    const size_t before = AllocationCounter::count();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(fields.tokenize(line));
+
+    state.counters["allocs_per_row"] = AllocationCounter::perIteration(state, before);
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+BENCHMARK(BM_V2_CsvTokenize)->Arg(0)->Arg(1);
+
+static void BM_V2_UserToFileString(benchmark::State& state)
+{
+    const User user = User::fromFileString(RECORD);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(user.toFileString());
+}
+BENCHMARK(BM_V2_UserToFileString);
+
+// ==================== UserRepository ====================
+
+static void BM_V2_GetNextId(benchmark::State& state)
+{
+    auto repository = MakeRepository(static_cast<int>(state.range(0)));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(repository->getNextId());
+}
+BENCHMARK(BM_V2_GetNextId)->Arg(1000)->Arg(100000)->Arg(1000000);
+
+static void BM_V2_Update(benchmark::State& state)
+{
+    const int rows = static_cast<int>(state.range(0));
+    auto repository = MakeRepository(rows);
+
+    std::unique_ptr<User> user(repository->read("user" + std::to_string(rows / 2)));
+
+    int version = 0;
+    for (auto _ : state) {
+        user->setEmail("user" + std::to_string(version++) + "@update.example.com");
+        repository->update(*user);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_V2_Update)->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+
+// exists() for stored usernames (hit=1) against never-stored ones (hit=0),
+// which the Bloom filter answers without reading the index
+static void BM_V2_UsernameExists(benchmark::State& state)
+{
+    const int rows = static_cast<int>(state.range(0));
+    const bool hit = state.range(1) != 0;
+    auto repository = MakeRepository(rows);
+
+    std::vector<std::string> names;
+    for (int i = 1; i <= 1024; ++i)
+        names.push_back((hit ? "user" : "nobody") + std::to_string(i * (rows / 1024 + 1) % rows + 1));
+
+    size_t next = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(repository->exists(names[next++ & 1023]));
+}
+BENCHMARK(BM_V2_UsernameExists)->ArgNames({ "rows", "hit" })
+    ->Args({ 1000, 0 })->Args({ 1000, 1 })->Args({ 1000000, 0 })->Args({ 1000000, 1 });
+
+// Concurrent writes through the group-commit writer. Args are the batch
+// window in microseconds and the change: 0 updates one row per thread,
+// 1 registers new users, whose ids the writer assigns. items_per_second
+// is durable commits/sec across all threads; latency_us is how long each
+// caller waits per change.
+static void BM_V2_GroupCommit(benchmark::State& state)
+{
+    static std::unique_ptr<UserRepository> repository;
+    const bool create = state.range(1) != 0;
+
+    if (state.thread_index() == 0) {
+        GroupCommitOptions options;
+        options.batchWindow = std::chrono::microseconds(state.range(0));
+        repository = MakeRepository(1000, options);
+    }
+
+    // One row per thread, so no update conflicts with another
+    std::unique_ptr<User> user;
+    int version = 0;
+    auto started = std::chrono::steady_clock::now();
+
+    for (auto _ : state) {
+        const std::string tag = "t" + std::to_string(state.thread_index()) + "v" + std::to_string(version++);
+
+        if (create) {
+            // Distinct names, so a refusal can only be an id collision
+            if (repository->create(User(0, tag, "Passw0rd!", tag + "@commit.example.com")) == 0) {
+                state.SkipWithError("concurrent create refused");
+                break;
+            }
+            continue;
+        }
+
+        if (!user)
+            user.reset(repository->read("user" + std::to_string(state.thread_index() + 1)));
+
+        user->setEmail(tag + "@commit.example.com");
+        repository->update(*user);
+    }
+
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - started;
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["latency_us"] = benchmark::Counter(
+        elapsed.count() / std::max<benchmark::IterationCount>(1, state.iterations()),
+        benchmark::Counter::kAvgThreads);
+
+    if (state.thread_index() == 0) {
+        state.counters["changes_per_batch"] =
+            double(repository->changesCommitted()) / std::max<size_t>(1, repository->batchesCommitted());
+        repository.reset();
+    }
+}
+BENCHMARK(BM_V2_GroupCommit)->ArgNames({ "window_us", "create" })
+    ->ArgsProduct({ { 0, 200, 1000 }, { 0, 1 } })
+    ->ThreadRange(1, 16)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+// ==================== LoginThrottle ====================
+
+// Cost of the check in front of every login. Arg 0 admits a spread of
+// usernames; arg 1 is a username under attack, rejected every time.
+static void BM_V2_LoginThrottleAdmit(benchmark::State& state)
+{
+    static std::unique_ptr<LoginThrottle> throttle;
+
+    if (state.thread_index() == 0) {
+        throttle = std::make_unique<LoginThrottle>();
+        for (int i = 0; i < 100; ++i)
+            throttle->recordFailure("victim", "");
+    }
+
+    std::vector<std::string> usernames;
+    for (int i = 0; i < 1024; ++i)
+        usernames.push_back(state.range(0) == 0 ? "user" + std::to_string(i) : "victim");
+
+    size_t i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(throttle->admit(usernames[i++ % usernames.size()], "10.0.0.1"));
+
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        LoginThrottle::Metrics metrics = throttle->metrics();
+        state.counters["rejected"] = double(metrics.rejectedUsername + metrics.rejectedSource)
+            / std::max<uint64_t>(1, metrics.admitted + metrics.rejectedUsername + metrics.rejectedSource);
+        throttle.reset();
+    }
+}
+BENCHMARK(BM_V2_LoginThrottleAdmit)->Arg(0)->Arg(1)->ThreadRange(1, 8);
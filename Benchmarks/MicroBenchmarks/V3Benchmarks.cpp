@@ -0,0 +1,565 @@
+// V3Benchmarks.cpp : micro-benchmarks for the V3 Chronicle search engine,
+// trending tracker, engagement counters, home feeds and comment threads.
+
+#include "AllocationCounter.h"
+#include "../../V3_Chronicle_Blog System/include/core/Comment.h"
+#include "../../V3_Chronicle_Blog System/include/core/Post.h"
+#include "../../V3_Chronicle_Blog System/include/utils/CommentThread.h"
+#include "../../V3_Chronicle_Blog System/include/utils/EngagementCounters.h"
+#include "../../V3_Chronicle_Blog System/include/utils/FeedService.h"
+#include "../../V3_Chronicle_Blog System/include/utils/SearchEngine.h"
+#include "../../V3_Chronicle_Blog System/include/utils/TrendingTracker.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Synthetic posts: words drawn from a Zipf-distributed vocabulary, like
+// natural text, so a few terms have huge posting lists and most are rare
+class Corpus {
+public:
+    static constexpr size_t VOCABULARY = 50000;
+    static constexpr size_t TITLE_WORDS = 6;
+    static constexpr size_t CONTENT_WORDS = 80;
+
+    Corpus()
+    {
+        static const char* const SYLLABLES[] = {
+            "ka", "lo", "mi", "ne", "ru", "sa", "ti", "vo", "ze", "pa",
+            "do", "fi", "gu", "ha", "je", "ko", "lu", "ma", "no", "ri"
+        };
+
+        double total = 0;
+        for (size_t rank = 0; rank < VOCABULARY; ++rank) {
+            std::string word;
+            size_t value = rank;
+            do {
+                word += SYLLABLES[value % 20];
+                value /= 20;
+            } while (value > 0);
+
+            words.push_back(word);
+            total += 1.0 / (rank + 1);
+            cumulative.push_back(total);
+        }
+
+        for (double& weight : cumulative)
+            weight /= total;
+    }
+
+    // The word at a frequency rank, 0 being the most common
+    const std::string& word(size_t rank) const { return words[rank]; }
+
+    Post post(int id)
+    {
+        return Post(id, id % 1000 + 1, text(TITLE_WORDS), text(CONTENT_WORDS), 0, 0);
+    }
+
+private:
+    std::string text(size_t count)
+    {
+        std::string result;
+        for (size_t i = 0; i < count; ++i) {
+            if (i > 0)
+                result += ' ';
+            const double u = (next() >> 11) * (1.0 / 9007199254740992.0);
+            result += words[std::lower_bound(cumulative.begin(), cumulative.end(), u) - cumulative.begin()];
+        }
+        return result;
+    }
+
+    uint64_t next()
+    {
+        // splitmix64
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    std::vector<std::string> words;
+    std::vector<double> cumulative;
+    uint64_t state = 42;
+};
+
+struct IndexedCorpus {
+    Corpus corpus;
+    SearchEngine engine;
+    size_t heapBytes = 0;
+};
+
+// Built once per size and kept for the whole run
+IndexedCorpus& Indexed(int posts)
+{
+    static std::map<int, std::unique_ptr<IndexedCorpus>> built;
+
+    std::unique_ptr<IndexedCorpus>& entry = built[posts];
+    if (!entry) {
+        entry = std::make_unique<IndexedCorpus>();
+        const size_t before = AllocationCounter::liveBytes();
+        for (int id = 1; id <= posts; ++id)
+            entry->engine.indexPost(entry->corpus.post(id));
+        entry->heapBytes = AllocationCounter::liveBytes() - before;
+    }
+
+    return *entry;
+}
+
+} // namespace
+
+// ==================== SearchEngine ====================
+
+// Incremental indexPost() throughput on a growing index
+static void BM_V3_SearchIndexPost(benchmark::State& state)
+{
+    Corpus corpus;
+    SearchEngine engine;
+    std::vector<Post> posts;
+    for (int id = 1; id <= 4096; ++id)
+        posts.push_back(corpus.post(id));
+
+    size_t next = 0;
+    for (auto _ : state) {
+        Post& post = posts[next++ & 4095];
+        engine.indexPost(Post(static_cast<int>(next), post.getAuthorId(), post.getTitle(),
+            post.getContent(), 0, 0));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_V3_SearchIndexPost)->Unit(benchmark::kMicrosecond);
+
+// Top-10 query latency. query: 0 = one common term, 1 = common AND
+// mid-frequency, 2 = rare AND common (skips do the work), 3 = three terms.
+// index_MB is the engine's heap footprint, bytes_per_posting the encoded
+// posting lists alone.
+static void BM_V3_Search(benchmark::State& state)
+{
+    IndexedCorpus& indexed = Indexed(static_cast<int>(state.range(0)));
+    const Corpus& corpus = indexed.corpus;
+
+    std::string query;
+    switch (state.range(1)) {
+    case 0: query = corpus.word(5); break;
+    case 1: query = corpus.word(5) + " " + corpus.word(300); break;
+    case 2: query = corpus.word(5000) + " " + corpus.word(5); break;
+    default: query = corpus.word(50) + " " + corpus.word(300) + " " + corpus.word(2000); break;
+    }
+
+    size_t results = 0;
+    for (auto _ : state) {
+        std::vector<SearchResult> hits = indexed.engine.search(query, 10);
+        results = hits.size();
+        benchmark::DoNotOptimize(hits.data());
+    }
+
+    const SearchEngine::Stats stats = indexed.engine.stats();
+    state.counters["results"] = static_cast<double>(results);
+    state.counters["index_MB"] = indexed.heapBytes / 1048576.0;
+    state.counters["bytes_per_posting"] = double(stats.postingBytes) / stats.postings;
+}
+BENCHMARK(BM_V3_Search)->ArgNames({ "posts", "query" })
+    ->ArgsProduct({ { 100000, 1000000 }, { 0, 1, 2, 3 } })->Unit(benchmark::kMicrosecond);
+
+// ==================== TrendingTracker ====================
+
+namespace {
+
+const int TRENDING_POSTS = 100000;
+const int64_t TRENDING_START = 1700000000;
+
+// Engagement skews toward a few hot posts, like real traffic
+int HotPost(uint64_t i)
+{
+    uint64_t z = i * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 31)) * 0xbf58476d1ce4e5b9ull;
+    const uint64_t spread = (z >> 33) % TRENDING_POSTS;
+    return static_cast<int>((spread * spread) / TRENDING_POSTS) + 1;
+}
+
+std::unique_ptr<TrendingTracker> MakeTracker()
+{
+    auto tracker = std::make_unique<TrendingTracker>();
+    for (int id = 1; id <= TRENDING_POSTS; ++id)
+        tracker->addPost(id, TRENDING_START + id);
+    for (uint64_t i = 0; i < 1000000; ++i)
+        tracker->record(HotPost(i), EngagementType(i % 3), TRENDING_START + static_cast<int64_t>(i / 10));
+    return tracker;
+}
+
+} // namespace
+
+// Events per second the tracker absorbs, writers sharing one tracker
+static void BM_V3_TrendingRecord(benchmark::State& state)
+{
+    static std::unique_ptr<TrendingTracker> tracker;
+
+    if (state.thread_index() == 0)
+        tracker = MakeTracker();
+
+    uint64_t i = static_cast<uint64_t>(state.thread_index()) << 40;
+    for (auto _ : state) {
+        ++i;
+        tracker->record(HotPost(i), EngagementType(i % 3), TRENDING_START + 100000 + static_cast<int64_t>(i & 0xffff) / 10);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0)
+        tracker.reset();
+}
+BENCHMARK(BM_V3_TrendingRecord)->ThreadRange(1, 8)->UseRealTime();
+
+// Top-10 latency over 100K posts. writer: 0 = quiet, 1 = a background
+// thread recording events flat out the whole time
+static void BM_V3_TrendingTop(benchmark::State& state)
+{
+    std::unique_ptr<TrendingTracker> tracker = MakeTracker();
+
+    std::atomic<bool> stop{ false };
+    std::atomic<uint64_t> written{ 0 };
+    std::thread writer;
+    if (state.range(0) == 1) {
+        writer = std::thread([&] {
+            for (uint64_t i = 1; !stop.load(std::memory_order_relaxed); ++i) {
+                tracker->record(HotPost(i), EngagementType(i % 3), TRENDING_START + 100000 + static_cast<int64_t>(i / 10));
+                written.store(i, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    for (auto _ : state) {
+        std::vector<TrendingEntry> top = tracker->trending(10);
+        benchmark::DoNotOptimize(top.data());
+    }
+
+    stop = true;
+    if (writer.joinable())
+        writer.join();
+
+    state.counters["writer_events"] = static_cast<double>(written.load());
+}
+BENCHMARK(BM_V3_TrendingTop)->ArgName("writer")->Arg(0)->Arg(1)->UseRealTime();
+
+// Baseline: what getTrendingPosts() does without the tracker - score
+// every post and sort for the top 10 on each request
+static void BM_V3_TrendingResort(benchmark::State& state)
+{
+    struct Counts {
+        int postId;
+        int views, likes, comments;
+        int64_t lastActivity;
+    };
+
+    std::vector<Counts> posts;
+    for (int id = 1; id <= TRENDING_POSTS; ++id)
+        posts.push_back(Counts{ id, 0, 0, 0, TRENDING_START + id });
+    for (uint64_t i = 0; i < 1000000; ++i) {
+        Counts& post = posts[HotPost(i) - 1];
+        (i % 3 == 0 ? post.views : i % 3 == 1 ? post.likes : post.comments)++;
+        post.lastActivity = TRENDING_START + static_cast<int64_t>(i / 10);
+    }
+
+    const int64_t now = TRENDING_START + 100000;
+    std::vector<std::pair<double, int>> scored(posts.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < posts.size(); ++i) {
+            const Counts& post = posts[i];
+            const double points = post.views + 10.0 * post.likes + 5.0 * post.comments;
+            scored[i] = { points * std::exp2(double(post.lastActivity - now) / (6 * 3600)), post.postId };
+        }
+        std::partial_sort(scored.begin(), scored.begin() + 10, scored.end(),
+            [](const auto& a, const auto& b) { return a.first > b.first; });
+        benchmark::DoNotOptimize(scored.data());
+    }
+}
+BENCHMARK(BM_V3_TrendingResort)->Unit(benchmark::kMicrosecond);
+
+// ==================== EngagementCounters ====================
+
+// Views of one hot post from every thread: striped counters
+static void BM_V3_RecordView(benchmark::State& state)
+{
+    static std::unique_ptr<EngagementCounters> counters;
+
+    if (state.thread_index() == 0)
+        counters = std::make_unique<EngagementCounters>();
+
+    for (auto _ : state)
+        counters->recordView(1);
+
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0)
+        counters.reset();
+}
+BENCHMARK(BM_V3_RecordView)->ThreadRange(1, 8)->UseRealTime();
+
+// Baseline: the design's single views counter, shared by all threads
+static void BM_V3_RecordViewShared(benchmark::State& state)
+{
+    static std::atomic<uint64_t> views{ 0 };
+
+    for (auto _ : state)
+        views.fetch_add(1, std::memory_order_relaxed);
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_V3_RecordViewShared)->ThreadRange(1, 8)->UseRealTime();
+
+// hasLiked() on a post with arg likers; the check like() makes first
+static void BM_V3_HasLiked(benchmark::State& state)
+{
+    EngagementCounters counters(EngagementCounters::Flush(), EngagementOptions{ std::chrono::milliseconds(0) });
+    const uint32_t likers = static_cast<uint32_t>(state.range(0));
+    for (uint32_t user = 0; user < likers; ++user)
+        counters.like(1, user * 3);
+
+    uint32_t user = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(counters.hasLiked(1, user));
+        user = (user + 7919) % (likers * 3);
+    }
+}
+BENCHMARK(BM_V3_HasLiked)->Arg(1000)->Arg(100000);
+
+// Baseline: the design's isLikedBy(), a scan of the likes vector
+static void BM_V3_HasLikedScan(benchmark::State& state)
+{
+    const uint32_t likers = static_cast<uint32_t>(state.range(0));
+    std::vector<uint32_t> likes;
+    for (uint32_t user = 0; user < likers; ++user)
+        likes.push_back(user * 3);
+
+    uint32_t user = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::find(likes.begin(), likes.end(), user) != likes.end());
+        user = (user + 7919) % (likers * 3);
+    }
+}
+BENCHMARK(BM_V3_HasLikedScan)->Arg(1000)->Arg(100000);
+
+// ==================== FeedService ====================
+
+namespace {
+
+const int FEED_USERS = 20000;
+const int FEED_FOLLOWS = 50;   // per user
+const int FEED_POSTS = 100000;
+
+// strategy: 0 = hybrid (pull authors over 1000 followers), 1 = pull
+// everyone, 2 = push to everyone
+FeedOptions FeedStrategy(int64_t strategy)
+{
+    FeedOptions options;
+    options.pullThreshold = strategy == 0 ? 1000 : strategy == 1 ? 0 : SIZE_MAX;
+    return options;
+}
+
+// Followed authors picked with a Zipf skew, so a few have most of the
+// followers, like a real follows graph
+FeedService& FeedGraph(int64_t strategy)
+{
+    static std::map<int64_t, std::unique_ptr<FeedService>> built;
+
+    std::unique_ptr<FeedService>& feed = built[strategy];
+    if (!feed) {
+        feed = std::make_unique<FeedService>(FeedStrategy(strategy));
+
+        std::vector<double> cumulative;
+        double total = 0;
+        for (int rank = 1; rank <= FEED_USERS; ++rank)
+            cumulative.push_back(total += 1.0 / rank);
+
+        uint64_t state = 7;
+        auto next = [&state] {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        };
+
+        for (int user = 0; user < FEED_USERS; ++user) {
+            for (int i = 0; i < FEED_FOLLOWS; ++i) {
+                const double u = (next() >> 11) * (1.0 / 9007199254740992.0) * total;
+                const int author = static_cast<int>(std::lower_bound(cumulative.begin(), cumulative.end(), u) - cumulative.begin());
+                if (author != user)
+                    feed->follow(user, author);
+            }
+        }
+
+        for (int post = 0; post < FEED_POSTS; ++post)
+            feed->publish(static_cast<int>(next() % FEED_USERS), post);
+    }
+
+    return *feed;
+}
+
+} // namespace
+
+// First page of 20 for a random user
+static void BM_V3_FeedRead(benchmark::State& state)
+{
+    FeedService& feed = FeedGraph(state.range(0));
+
+    uint64_t user = 0;
+    size_t items = 0;
+    for (auto _ : state) {
+        user = (user + 7919) % FEED_USERS;
+        FeedPage page = feed.feed(static_cast<int>(user), 20);
+        items += page.items.size();
+        benchmark::DoNotOptimize(page.items.data());
+    }
+
+    state.counters["items"] = static_cast<double>(items) / state.iterations();
+}
+BENCHMARK(BM_V3_FeedRead)->ArgName("strategy")->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMicrosecond);
+
+// Publishing one post, fan-out included, by an author picked uniformly
+static void BM_V3_FeedPublish(benchmark::State& state)
+{
+    FeedService& feed = FeedGraph(state.range(0));
+
+    int post = FEED_POSTS;
+    for (auto _ : state) {
+        const int author = static_cast<int>((uint64_t(post) * 7919) % FEED_USERS);
+        feed.publish(author, post++);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_V3_FeedPublish)->ArgName("strategy")->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMicrosecond);
+
+// ==================== CommentThread ====================
+
+namespace {
+
+const int THREAD_COMMENTS = 100000;
+
+// A viral post's thread: a quarter top-level comments, the rest replies,
+// mostly to recent comments, so sub-threads run deep
+std::vector<int> ThreadParents()
+{
+    std::vector<int> parents(THREAD_COMMENTS + 1, 0);
+    uint64_t state = 11;
+    for (int id = 2; id <= THREAD_COMMENTS; ++id) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        const uint64_t r = state >> 33;
+        if (r % 4 != 0)
+            parents[id] = (r % 3 != 0) ? std::max(1, id - 1 - static_cast<int>((r >> 8) % 50))
+                                      : 1 + static_cast<int>((r >> 8) % (id - 1));
+    }
+    return parents;
+}
+
+CommentThread& ViralThread()
+{
+    static std::unique_ptr<CommentThread> thread;
+    if (!thread) {
+        thread = std::make_unique<CommentThread>();
+        const std::vector<int> parents = ThreadParents();
+        for (int id = 1; id <= THREAD_COMMENTS; ++id)
+            thread->add(Comment(id, 1, id % 1000, parents[id], "comment text", id));
+    }
+    return *thread;
+}
+
+// The design's Comment: a heap node per comment linked to its replies
+struct TreeComment {
+    Comment comment;
+    std::vector<TreeComment*> replies;
+};
+
+struct PointerThread {
+    std::vector<std::unique_ptr<TreeComment>> nodes;
+    std::vector<TreeComment*> topLevel;
+};
+
+PointerThread& ViralPointerThread()
+{
+    static std::unique_ptr<PointerThread> thread;
+    if (!thread) {
+        thread = std::make_unique<PointerThread>();
+        const std::vector<int> parents = ThreadParents();
+        thread->nodes.resize(THREAD_COMMENTS + 1);
+        for (int id = 1; id <= THREAD_COMMENTS; ++id) {
+            thread->nodes[id].reset(new TreeComment{ Comment(id, 1, id % 1000, parents[id], "comment text", id), {} });
+            if (parents[id] == 0)
+                thread->topLevel.push_back(thread->nodes[id].get());
+            else
+                thread->nodes[parents[id]]->replies.push_back(thread->nodes[id].get());
+        }
+    }
+    return *thread;
+}
+
+// Depth-first walk that skips offset comments before collecting
+void CollectPage(const TreeComment* node, uint32_t depth, size_t& skip, size_t count,
+    std::vector<std::pair<const Comment*, uint32_t>>& page)
+{
+    if (page.size() == count)
+        return;
+    if (skip > 0)
+        --skip;
+    else
+        page.emplace_back(&node->comment, depth);
+
+    for (const TreeComment* reply : node->replies)
+        CollectPage(reply, depth + 1, skip, count, page);
+}
+
+} // namespace
+
+// A page of 50 rows at a random offset into a 100K-comment thread
+static void BM_V3_CommentPage(benchmark::State& state)
+{
+    CommentThread& thread = ViralThread();
+
+    uint64_t offset = 0;
+    for (auto _ : state) {
+        offset = (offset + 7919) % THREAD_COMMENTS;
+        std::vector<CommentRow> page = thread.page(offset, 50);
+        benchmark::DoNotOptimize(page.data());
+    }
+}
+BENCHMARK(BM_V3_CommentPage)->Unit(benchmark::kMicrosecond);
+
+// Baseline: the same page from the design's pointer tree
+static void BM_V3_CommentPagePointerTree(benchmark::State& state)
+{
+    PointerThread& thread = ViralPointerThread();
+
+    uint64_t offset = 0;
+    for (auto _ : state) {
+        offset = (offset + 7919) % THREAD_COMMENTS;
+        std::vector<std::pair<const Comment*, uint32_t>> page;
+        size_t skip = offset;
+        for (const TreeComment* node : thread.topLevel)
+            CollectPage(node, 0, skip, 50, page);
+        benchmark::DoNotOptimize(page.data());
+    }
+}
+BENCHMARK(BM_V3_CommentPagePointerTree)->Unit(benchmark::kMicrosecond);
+
+// Adding a reply to a random comment of a 100K-comment thread
+static void BM_V3_CommentReply(benchmark::State& state)
+{
+    CommentThread thread;
+    const std::vector<int> parents = ThreadParents();
+    for (int id = 1; id <= THREAD_COMMENTS; ++id)
+        thread.add(Comment(id, 1, id % 1000, parents[id], "comment text", id));
+
+    int id = THREAD_COMMENTS;
+    for (auto _ : state) {
+        ++id;
+        thread.add(Comment(id, 1, 1, 1 + (id * 7919) % THREAD_COMMENTS, "reply", id));
+    }
+}
+BENCHMARK(BM_V3_CommentReply)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,220 @@
+// ReplayDriver.cpp : headless replay of an auth workload against the V2
+// storage path (UserRepository + AuthManager), reporting throughput and
+// latency percentiles per operation type.
+//
+// Usage: ReplayDriver <workload file> [--data <dir>] [--csv]
+
+#include "Workload.h"
+#include "../../V2_Guardian_OOP Refactor/include/AuthManager.h"
+#include "../../V2_Guardian_OOP Refactor/include/PasswordHasher.h"
+#include "../../V2_Guardian_OOP Refactor/include/UserRecordFile.h"
+#include "../../V2_Guardian_OOP Refactor/include/UserRepository.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* const PASSWORD = "Replay#Pass1";
+
+struct OpStats {
+    std::vector<uint64_t> latenciesNs;
+    uint64_t failed = 0;
+    uint64_t totalNs = 0;
+};
+
+// Nearest-rank percentile of an ascending sample
+double percentileUs(const std::vector<uint64_t>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+
+    size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::max<size_t>(rank, 1) - 1] / 1000.0;
+}
+
+// Start from an empty table, then write the preloaded users in one pass
+// rather than through create(), which rewrites the file per call
+void prepareData(const std::string& dataFile, const Workload::Spec& spec,
+    const PasswordHasher& hasher)
+{
+    namespace fs = std::filesystem;
+    fs::path path(dataFile);
+    fs::create_directories(path.parent_path());
+
+    // Every file the repository keeps beside the table - indexes, filters,
+    // the lock, leftover temp files - shares its stem
+    const std::string prefix = path.stem().string() + ".";
+    std::vector<fs::path> stale;
+    for (const fs::directory_entry& entry : fs::directory_iterator(path.parent_path())) {
+        if (entry.path().filename().string().compare(0, prefix.size(), prefix) == 0)
+            stale.push_back(entry.path());
+    }
+
+    for (const fs::path& file : stale)
+        fs::remove(file);
+
+    const std::string passwordHash = hasher.hash(PASSWORD);
+
+    std::vector<User> users;
+    users.reserve(spec.users);
+    for (uint32_t user = 0; user < spec.users; ++user) {
+        users.emplace_back(static_cast<int>(user) + 1, Workload::username(user),
+            passwordHash, Workload::email(user, 0));
+    }
+
+    if (!UserRecordFile::write(dataFile, users))
+        throw std::runtime_error("cannot write " + dataFile);
+}
+
+bool runOp(const Workload::Op& op, uint32_t sequence,
+    UserRepository& repository, AuthManager& auth)
+{
+    const std::string username = Workload::username(op.user);
+
+    switch (op.type) {
+    case Workload::REGISTER:
+        return auth.registerUser(username, PASSWORD, Workload::email(op.user, 0));
+
+    case Workload::LOGIN:
+        return auth.login(username, PASSWORD);
+
+    case Workload::UPDATE: {
+        User* user = repository.read(username);
+        if (!user)
+            return false;
+
+        user->setEmail(Workload::email(op.user, sequence + 1));
+        bool updated = repository.update(*user);
+        delete user;
+        return updated;
+    }
+
+    case Workload::DELETE:
+        return repository.remove(username);
+
+    default:
+        return false;
+    }
+}
+
+void printReport(const std::vector<OpStats>& stats, double wallSeconds,
+    size_t operations, bool csv)
+{
+    char line[160];
+
+    if (csv)
+        std::cout << "operation,count,failed,ops_per_sec,p50_us,p99_us,p999_us\n";
+    else {
+        std::snprintf(line, sizeof(line), "%-10s %10s %8s %12s %11s %11s %11s\n",
+            "operation", "count", "failed", "ops/sec", "p50 us", "p99 us", "p999 us");
+        std::cout << line;
+    }
+
+    for (int type = 0; type < Workload::OP_TYPE_COUNT; ++type) {
+        const OpStats& op = stats[type];
+        if (op.latenciesNs.empty())
+            continue;
+
+        double opsPerSec = op.latenciesNs.size() / (op.totalNs / 1e9);
+        std::snprintf(line, sizeof(line),
+            csv ? "%s,%zu,%llu,%.1f,%.2f,%.2f,%.2f\n"
+                : "%-10s %10zu %8llu %12.1f %11.2f %11.2f %11.2f\n",
+            Workload::name(static_cast<Workload::OpType>(type)),
+            op.latenciesNs.size(), static_cast<unsigned long long>(op.failed), opsPerSec,
+            percentileUs(op.latenciesNs, 0.50),
+            percentileUs(op.latenciesNs, 0.99),
+            percentileUs(op.latenciesNs, 0.999));
+        std::cout << line;
+    }
+
+    if (!csv) {
+        std::snprintf(line, sizeof(line), "\n%zu operations in %.3f s (%.1f ops/sec)\n",
+            operations, wallSeconds, operations / wallSeconds);
+        std::cout << line;
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::string workloadPath;
+    std::string dataDir = "replay-data";
+    bool csv = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--data" && i + 1 < argc) dataDir = argv[++i];
+        else if (arg == "--csv")             csv = true;
+        else if (workloadPath.empty())       workloadPath = arg;
+        else {
+            workloadPath.clear();
+            break;
+        }
+    }
+
+    if (workloadPath.empty()) {
+        std::cerr << "Usage: ReplayDriver <workload file> [--data <dir>] [--csv]\n";
+        return 2;
+    }
+
+    try {
+        const Workload::Spec spec = Workload::parse(workloadPath);
+        const std::vector<Workload::Op> ops = Workload::generate(spec);
+
+        PasswordHasher::Params params;
+        params.memoryKiB = spec.hashMemoryKiB;
+        params.iterations = spec.hashIterations;
+        const PasswordHasher hasher(params);
+
+        const std::string dataFile = dataDir + "/users.dat";
+        prepareData(dataFile, spec, hasher);
+
+        UserRepository repository(dataFile);
+        AuthManager auth(repository, hasher);
+
+        std::vector<OpStats> stats(Workload::OP_TYPE_COUNT);
+        const Clock::time_point runStart = Clock::now();
+
+        for (uint32_t i = 0; i < ops.size(); ++i) {
+            const Clock::time_point start = Clock::now();
+            bool ok = runOp(ops[i], i, repository, auth);
+            const uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now() - start).count();
+
+            OpStats& op = stats[ops[i].type];
+            op.latenciesNs.push_back(elapsed);
+            op.totalNs += elapsed;
+            op.failed += ok ? 0 : 1;
+
+            if (ops[i].type == Workload::LOGIN)
+                auth.logout();
+        }
+
+        const double wallSeconds = std::chrono::duration<double>(Clock::now() - runStart).count();
+
+        for (OpStats& op : stats)
+            std::sort(op.latenciesNs.begin(), op.latenciesNs.end());
+
+        if (!csv) {
+            std::cout << "Workload " << workloadPath << ": " << spec.users << " users, "
+                << ops.size() << " operations, zipf " << spec.zipf << "\n\n";
+        }
+        printReport(stats, wallSeconds, ops.size(), csv);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "ReplayDriver: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+#include "Workload.h"
+#include <cmath>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+// ==================== Spec parsing ====================
+
+Workload::Spec Workload::parse(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("cannot open workload file " + path);
+
+    Spec spec;
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream in(line);
+        std::string key;
+        if (!(in >> key))
+            continue;
+
+        bool ok = true;
+        if (key == "seed")                 ok = static_cast<bool>(in >> spec.seed);
+        else if (key == "users")           ok = static_cast<bool>(in >> spec.users);
+        else if (key == "operations")      ok = static_cast<bool>(in >> spec.operations);
+        else if (key == "zipf")            ok = static_cast<bool>(in >> spec.zipf) && spec.zipf >= 0 && spec.zipf != 1;
+        else if (key == "hash_memory_kib") ok = static_cast<bool>(in >> spec.hashMemoryKiB);
+        else if (key == "hash_iterations") ok = static_cast<bool>(in >> spec.hashIterations);
+        else if (key == "mix") {
+            std::fill(std::begin(spec.mix), std::end(spec.mix), 0);
+
+            std::string weight;
+            while (ok && in >> weight) {
+                size_t eq = weight.find('=');
+                ok = false;
+
+                for (int type = 0; type < OP_TYPE_COUNT && eq != std::string::npos; ++type) {
+                    if (weight.compare(0, eq, name(static_cast<OpType>(type))) == 0) {
+                        spec.mix[type] = static_cast<uint32_t>(std::stoul(weight.substr(eq + 1)));
+                        ok = true;
+                    }
+                }
+            }
+
+            ok = ok && std::accumulate(std::begin(spec.mix), std::end(spec.mix), 0u) > 0;
+        }
+        else ok = false;
+
+        if (!ok)
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": invalid line");
+    }
+
+    return spec;
+}
+
+// ==================== Operation sequence ====================
+
+std::vector<Workload::Op> Workload::generate(const Spec& spec)
+{
+    std::mt19937_64 random(spec.seed);
+    std::discrete_distribution<int> pickType(std::begin(spec.mix), std::end(spec.mix));
+    ZipfianGenerator pickRank(spec.users, spec.zipf);
+
+    // rank -> user number. Rank 0 is the hottest account. Registrations join
+    // at the cold end; a deleted account's rank is taken over by the coldest
+    // one, so every login/update targets an account that exists
+    std::vector<uint32_t> ranks(spec.users);
+    std::iota(ranks.begin(), ranks.end(), 0u);
+    uint32_t nextUser = spec.users;
+
+    std::vector<Op> ops;
+    ops.reserve(spec.operations);
+
+    for (uint32_t i = 0; i < spec.operations; ++i) {
+        OpType type = static_cast<OpType>(pickType(random));
+        if (ranks.empty())
+            type = REGISTER;
+
+        if (type == REGISTER) {
+            ops.push_back({ REGISTER, nextUser });
+            ranks.push_back(nextUser++);
+            pickRank.grow();
+            continue;
+        }
+
+        uint32_t rank = pickRank.next(random);
+        ops.push_back({ type, ranks[rank] });
+
+        if (type == DELETE) {
+            ranks[rank] = ranks.back();
+            ranks.pop_back();
+            pickRank.shrink();
+        }
+    }
+
+    return ops;
+}
+
+// ==================== Naming ====================
+
+const char* Workload::name(OpType type)
+{
+    static const char* const names[OP_TYPE_COUNT] = { "register", "login", "update", "delete" };
+    return names[type];
+}
+
+std::string Workload::username(uint32_t user)
+{
+    return "user" + std::to_string(user);
+}
+
+std::string Workload::email(uint32_t user, uint32_t version)
+{
+    return username(user) + "." + std::to_string(version) + "@replay.test";
+}
+
+// ==================== ZipfianGenerator ====================
+
+ZipfianGenerator::ZipfianGenerator(uint32_t n, double theta)
+    : n(0), theta(theta),
+      zeta2(1.0 + std::pow(0.5, theta)),
+      alpha(1.0 / (1.0 - theta))
+{
+    for (uint32_t i = 0; i < n; ++i)
+        grow();
+}
+
+uint32_t ZipfianGenerator::next(std::mt19937_64& random)
+{
+    double u = std::uniform_real_distribution<double>(0.0, 1.0)(random);
+    double uz = u * zetan;
+
+    if (uz < 1.0)
+        return 0;
+    if (uz < zeta2 || n < 2)
+        return n < 2 ? 0 : 1;
+
+    uint32_t rank = static_cast<uint32_t>(n * std::pow(eta * u - eta + 1.0, alpha));
+    return rank < n ? rank : n - 1;
+}
+
+void ZipfianGenerator::grow()
+{
+    ++n;
+    zetan += 1.0 / std::pow(static_cast<double>(n), theta);
+    updateConstants();
+}
+
+void ZipfianGenerator::shrink()
+{
+    zetan -= 1.0 / std::pow(static_cast<double>(n), theta);
+    --n;
+    updateConstants();
+}
+
+void ZipfianGenerator::updateConstants()
+{
+    eta = n < 2 ? 0 : (1.0 - std::pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+}
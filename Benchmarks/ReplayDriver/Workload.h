@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// A replayable auth workload.
+//
+// The spec file is line based; '#' starts a comment:
+//
+//     seed             42
+//     users            10000          # preloaded before timing starts
+//     operations       20000
+//     mix              register=5 login=80 update=10 delete=5
+//     zipf             0.99           # user selection skew, 0 = uniform
+//     hash_memory_kib  64             # Argon2id cost used by the run
+//     hash_iterations  1
+//
+// generate() expands a spec into a fixed operation sequence, so the same
+// file and seed always replay the same requests in the same order.
+class Workload {
+public:
+    enum OpType { REGISTER, LOGIN, UPDATE, DELETE, OP_TYPE_COUNT };
+
+    struct Op {
+        OpType type;
+        uint32_t user; // user number; the account is named "user<number>"
+    };
+
+    struct Spec {
+        uint64_t seed = 42;
+        uint32_t users = 10000;
+        uint32_t operations = 20000;
+        uint32_t mix[OP_TYPE_COUNT] = { 5, 80, 10, 5 };
+        double zipf = 0.99;
+        uint32_t hashMemoryKiB = 64;
+        uint32_t hashIterations = 1;
+    };
+
+public:
+    // Throws std::runtime_error naming the offending line
+    static Spec parse(const std::string& path);
+
+    static std::vector<Op> generate(const Spec& spec);
+
+    static const char* name(OpType type);
+    static std::string username(uint32_t user);
+    static std::string email(uint32_t user, uint32_t version);
+};
+
+// Zipfian ranks over [0, n) using the rejection-free method of Gray et al.
+// ("Quickly Generating Billion-Record Synthetic Databases"). n may grow or
+// shrink one at a time; the normalising zeta sum is updated incrementally.
+class ZipfianGenerator {
+public:
+    ZipfianGenerator(uint32_t n, double theta);
+
+    uint32_t next(std::mt19937_64& random);
+
+    void grow();   // n + 1
+    void shrink(); // n - 1
+    uint32_t size() const { return n; }
+
+private:
+    void updateConstants();
+
+    uint32_t n;
+    double theta;
+    double zetan = 0;
+    double zeta2;
+    double alpha;
+    double eta = 0;
+};
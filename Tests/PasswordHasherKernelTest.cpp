@@ -0,0 +1,119 @@
+// PasswordHasherKernelTest.cpp : checks every Argon2id block-mixing kernel
+// the CPU supports (scalar, SSE2, AVX2) against the RFC 9106 test vector,
+// then against the scalar kernel on random inputs and cost parameters.
+//
+// Usage: PasswordHasherKernelTest [random cases] [seed]
+
+#include "../V2_Guardian_OOP Refactor/include/PasswordHasher.h"
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// RFC 9106 section 5.3
+const uint8_t RFC_9106_TAG[32] = {
+    0x0d, 0x64, 0x0d, 0xf5, 0x8d, 0x78, 0x76, 0x6c, 0x08, 0xc0, 0x37, 0xa3, 0x4a, 0x8b, 0x53, 0xc9,
+    0xd0, 0x1e, 0xf0, 0x45, 0x2d, 0x75, 0xb6, 0x5e, 0xb5, 0x25, 0x20, 0xe9, 0x6b, 0x01, 0xe6, 0x59
+};
+
+struct Case {
+    std::string password;
+    std::vector<uint8_t> salt;
+    PasswordHasher::Params params;
+};
+
+const char* kernelName(PasswordHasher::Kernel kernel)
+{
+    return kernel == PasswordHasher::AVX2 ? "AVX2" : kernel == PasswordHasher::SSE2 ? "SSE2" : "scalar";
+}
+
+std::vector<uint8_t> rfcTag()
+{
+    PasswordHasher::Params params;
+    params.memoryKiB = 32;
+    params.iterations = 3;
+    params.lanes = 4;
+
+    return PasswordHasher::argon2id(std::string(32, '\x01'), std::vector<uint8_t>(16, 0x02),
+        params, sizeof(RFC_9106_TAG), std::vector<uint8_t>(8, 0x03), std::vector<uint8_t>(12, 0x04));
+}
+
+// Small enough to run many, varied enough to reach every addressing path
+std::vector<Case> randomCases(size_t count, uint64_t seed)
+{
+    std::mt19937_64 random(seed);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<int> length(0, 64);
+    std::uniform_int_distribution<uint32_t> lanes(1, 4);
+    std::uniform_int_distribution<uint32_t> iterations(1, 3);
+    std::uniform_int_distribution<uint32_t> blocksPerLane(8, 160);
+
+    std::vector<Case> cases(count);
+    for (Case& c : cases) {
+        for (int i = length(random); i > 0; --i)
+            c.password += static_cast<char>(byte(random));
+
+        c.salt.resize(PasswordHasher::SALT_LENGTH);
+        for (uint8_t& b : c.salt)
+            b = static_cast<uint8_t>(byte(random));
+
+        c.params.lanes = lanes(random);
+        c.params.iterations = iterations(random);
+        c.params.memoryKiB = c.params.lanes * blocksPerLane(random);
+    }
+
+    return cases;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200;
+    const uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 9106;
+
+    const std::vector<Case> cases = randomCases(count, seed);
+
+    PasswordHasher::setKernel(PasswordHasher::SCALAR);
+    std::vector<std::vector<uint8_t>> expected;
+    for (const Case& c : cases)
+        expected.push_back(PasswordHasher::argon2id(c.password, c.salt, c.params));
+
+    size_t failures = 0;
+
+    for (int k = PasswordHasher::SCALAR; k <= PasswordHasher::bestSupportedKernel(); ++k) {
+        const PasswordHasher::Kernel kernel = static_cast<PasswordHasher::Kernel>(k);
+        PasswordHasher::setKernel(kernel);
+
+        if (rfcTag() != std::vector<uint8_t>(std::begin(RFC_9106_TAG), std::end(RFC_9106_TAG))) {
+            std::printf("%s: RFC 9106 test vector mismatch\n", kernelName(kernel));
+            ++failures;
+        }
+
+        size_t mismatches = 0;
+        for (size_t i = 0; i < cases.size(); ++i) {
+            if (PasswordHasher::argon2id(cases[i].password, cases[i].salt, cases[i].params) == expected[i])
+                continue;
+
+            if (++mismatches <= 5) {
+                std::printf("%s: m=%u t=%u p=%u differs from scalar\n", kernelName(kernel),
+                    cases[i].params.memoryKiB, cases[i].params.iterations, cases[i].params.lanes);
+            }
+        }
+
+        failures += mismatches;
+        std::printf("%s: RFC vector and %zu random cases checked\n", kernelName(kernel), cases.size());
+    }
+
+    PasswordHasher::setKernel(PasswordHasher::bestSupportedKernel());
+
+    if (failures != 0) {
+        std::printf("%zu failures\n", failures);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+// TimestampRoundTripTest.cpp : Timestamp::format and Timestamp::parse
+// round-trip every day from 1970 to 2128 and agree with strftime. Values
+// count wall-clock seconds with no zone, so gmtime gives the same fields.
+//
+// Usage: TimestampRoundTripTest [random seconds] [seed]
+
+#include "../V2_Guardian_OOP Refactor/include/Timestamp.h"
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <random>
+#include <string>
+
+namespace {
+
+const int64_t FIRST_SECOND = 1;                 // 1970-01-01 00:00:01; 0 means "not set"
+const int64_t LAST_SECOND = 5017593600LL - 1;   // 2128-12-31 23:59:59
+const int64_t SECONDS_PER_DAY = 86400;
+
+size_t failures = 0;
+
+void fail(const char* what, int64_t seconds, const std::string& detail)
+{
+    if (++failures <= 10)
+        std::printf("%s at %lld: %s\n", what, static_cast<long long>(seconds), detail.c_str());
+}
+
+std::string strftimeText(int64_t seconds)
+{
+    const time_t value = static_cast<time_t>(seconds);
+    tm fields;
+
+#ifdef _WIN32
+    gmtime_s(&fields, &value);
+#else
+    gmtime_r(&value, &fields);
+#endif
+
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &fields);
+    return text;
+}
+
+void checkSecond(int64_t seconds, bool withStrftime)
+{
+    const std::string text = Timestamp::format(seconds);
+
+    int64_t parsed = 0;
+    if (!Timestamp::parse(text, parsed) || parsed != seconds)
+        fail("parse(format) round trip", seconds, text + " parsed as " + std::to_string(parsed));
+
+    char fixed[Timestamp::TEXT_LENGTH];
+    Timestamp::formatTo(seconds, fixed);
+    if (std::string(fixed, sizeof(fixed)) != text)
+        fail("formatTo differs from format", seconds, text);
+
+    if (withStrftime) {
+        const std::string expected = strftimeText(seconds);
+        if (text != expected)
+            fail("strftime disagrees", seconds, text + " vs " + expected);
+    }
+}
+
+void checkRejected(const char* text)
+{
+    int64_t seconds = 0;
+    if (Timestamp::parse(text, seconds))
+        fail("accepted invalid text", seconds, text);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const size_t samples = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2128;
+
+    // strftime needs a 64-bit time_t past 2038
+    const bool strftimeCovers = sizeof(time_t) >= 8;
+    const int64_t strftimeLimit = strftimeCovers ? LAST_SECOND : INT32_MAX;
+
+    // Both ends of every day, which covers every month and leap day
+    for (int64_t day = 0; day * SECONDS_PER_DAY <= LAST_SECOND; ++day) {
+        const int64_t start = day * SECONDS_PER_DAY;
+        const int64_t end = start + SECONDS_PER_DAY - 1;
+
+        if (start >= FIRST_SECOND)
+            checkSecond(start, start <= strftimeLimit);
+        checkSecond(end, end <= strftimeLimit);
+    }
+
+    std::mt19937_64 random(seed);
+    std::uniform_int_distribution<int64_t> anySecond(FIRST_SECOND, LAST_SECOND);
+    for (size_t i = 0; i < samples; ++i) {
+        const int64_t seconds = anySecond(random);
+        checkSecond(seconds, seconds <= strftimeLimit);
+    }
+
+    // Calendar edges parse() must refuse
+    checkRejected("2100-02-29 00:00:00"); // not a leap year
+    checkRejected("2023-02-29 12:00:00");
+    checkRejected("2024-04-31 12:00:00");
+    checkRejected("2024-13-01 12:00:00");
+    checkRejected("2024-00-10 12:00:00");
+    checkRejected("2024-01-00 12:00:00");
+    checkRejected("2024-01-01 24:00:00");
+    checkRejected("2024-01-01 12:60:00");
+    checkRejected("2024-01-01 12:00");
+    checkRejected("2024/01/01 12:00:00");
+    checkRejected("2024-01-01T12:00:00");
+
+    int64_t leapDay = 0;
+    if (!Timestamp::parse("2000-02-29 00:00:00", leapDay) || Timestamp::format(leapDay) != "2000-02-29 00:00:00")
+        fail("refused a leap day", leapDay, "2000-02-29");
+
+    int64_t unset = -1;
+    if (!Timestamp::parse("", unset) || unset != 0 || !Timestamp::format(0).empty())
+        fail("empty text is not 0", unset, "");
+
+    // The cached clock against a fresh localtime; a second boundary
+    // between the two reads is retried once
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        const std::string cached(Timestamp::nowText());
+        const time_t now = time(nullptr);
+        tm fields;
+#ifdef _WIN32
+        localtime_s(&fields, &now);
+#else
+        localtime_r(&now, &fields);
+#endif
+        char expected[32];
+        std::strftime(expected, sizeof(expected), "%Y-%m-%d %H:%M:%S", &fields);
+
+        if (cached == expected)
+            break;
+        if (attempt == 1)
+            fail("nowText disagrees with localtime", Timestamp::now(), cached + " vs " + expected);
+    }
+
+    std::printf("1970-2128: every day and %zu random seconds checked%s\n", samples,
+        strftimeCovers ? "" : " (strftime only up to 2038)");
+
+    if (failures != 0) {
+        std::printf("%zu failures\n", failures);
+        return 1;
+    }
+
+    return 0;
+}
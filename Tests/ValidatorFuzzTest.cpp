@@ -0,0 +1,258 @@
+// ValidatorFuzzTest.cpp : differential fuzz test for the CharClass kernels.
+// Every kernel the CPU supports (scalar, SSE4.2, AVX2) runs the V2
+// validators and the raw primitives on random inputs, and each answer is
+// compared with the <cctype> validators they replaced.
+//
+// Usage: ValidatorFuzzTest [inputs per kernel] [seed]
+
+#include "../V2_Guardian_OOP Refactor/include/CharClass.h"
+#include "../V2_Guardian_OOP Refactor/include/Validator.h"
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// ==================== Reference validators ====================
+// The <cctype> implementations as they were before the kernels
+
+namespace legacy {
+
+    bool isLengthInRange(const std::string& str, int min, int max)
+    {
+        return static_cast<int>(str.length()) >= min && static_cast<int>(str.length()) <= max;
+    }
+
+    bool hasNoSpaces(const std::string& username)
+    {
+        for (char c : username) {
+            if (std::isspace(static_cast<unsigned char>(c)))
+                return false;
+        }
+        return true;
+    }
+
+    bool isValidUsername(const std::string& username)
+    {
+        if (!isLengthInRange(username, 3, 20) || !hasNoSpaces(username))
+            return false;
+
+        if (!std::isalpha(static_cast<unsigned char>(username[0])))
+            return false;
+
+        for (char c : username) {
+            if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_')
+                return false;
+        }
+
+        return true;
+    }
+
+    bool isPasswordStrong(const std::string& password)
+    {
+        bool hasUpper = false;
+        bool hasLower = false;
+        bool hasDigit = false;
+        bool hasSpecial = false;
+
+        for (char ch : password) {
+            unsigned char c = static_cast<unsigned char>(ch);
+
+            if (std::isupper(c))        hasUpper = true;
+            else if (std::islower(c))   hasLower = true;
+            else if (std::isdigit(c))   hasDigit = true;
+            else if (!std::isspace(c))  hasSpecial = true;
+            else return false;
+        }
+
+        return hasUpper && hasLower && hasDigit && hasSpecial;
+    }
+
+    bool isValidPassword(const std::string& password)
+    {
+        return isLengthInRange(password, 8, 50) && isPasswordStrong(password);
+    }
+
+    bool isValidEmail(const std::string& email)
+    {
+        if (email.empty() || email.length() > 100 || email.find('@') == std::string::npos)
+            return false;
+
+        size_t atPos = email.find('@');
+        if (atPos == 0)
+            return false;
+
+        size_t dotPos = email.find('.', atPos);
+        if (dotPos == std::string::npos || dotPos == atPos + 1 || dotPos == email.length() - 1)
+            return false;
+
+        if (email.find(' ') != std::string::npos)
+            return false;
+
+        for (size_t i = 0; i < atPos; ++i) {
+            unsigned char c = static_cast<unsigned char>(email[i]);
+            if (!std::isalnum(c) && c != '.' && c != '_' && c != '-')
+                return false;
+        }
+
+        return true;
+    }
+
+    bool containsOnlyAlphanumeric(const std::string& str)
+    {
+        for (char c : str) {
+            if (!std::isalnum(static_cast<unsigned char>(c)))
+                return false;
+        }
+        return true;
+    }
+
+    // The class a byte belongs to, from <cctype> alone
+    uint8_t classOf(unsigned char c)
+    {
+        if (std::isupper(c)) return CharClass::UPPER;
+        if (std::islower(c)) return CharClass::LOWER;
+        if (std::isdigit(c)) return CharClass::DIGIT;
+        if (c == '_')        return CharClass::UNDERSCORE;
+        if (c == '.' || c == '-') return CharClass::DOT_DASH;
+        if (std::isspace(c)) return CharClass::SPACE;
+        return CharClass::OTHER;
+    }
+
+} // namespace legacy
+
+// ==================== Input generation ====================
+
+// Mostly the bytes the validators care about, so random strings often
+// come close to valid; the rest is any byte, NUL and >= 0x80 included
+std::string randomInput(std::mt19937_64& random)
+{
+    static const std::string interesting =
+        "aZ09_.-@ \t\n\v\f\rAbcXyz Qq19!#$%+/=?^`{|}~";
+
+    std::uniform_int_distribution<int> shortLength(0, 24);
+    std::uniform_int_distribution<int> longLength(0, 130);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<int> anyByte(0, 255);
+    std::uniform_int_distribution<size_t> pick(0, interesting.size() - 1);
+
+    const int length = percent(random) < 70 ? shortLength(random) : longLength(random);
+
+    std::string input;
+    for (int i = 0; i < length; ++i) {
+        input += percent(random) < 85
+            ? interesting[pick(random)]
+            : static_cast<char>(anyByte(random));
+    }
+
+    // An email shape often enough to reach the later checks
+    if (percent(random) < 30 && length > 4)
+        input[length / 2] = '@';
+    if (percent(random) < 30 && length > 6)
+        input[length / 2 + 2] = '.';
+
+    return input;
+}
+
+const char* kernelName(CharClass::Kernel kernel)
+{
+    return kernel == CharClass::AVX2 ? "AVX2" : kernel == CharClass::SSE42 ? "SSE4.2" : "scalar";
+}
+
+// ==================== Comparison ====================
+
+struct Report {
+    size_t mismatches = 0;
+
+    void check(bool expected, bool actual, const char* what, const std::string& input,
+        CharClass::Kernel kernel)
+    {
+        if (expected == actual)
+            return;
+
+        // The first few are enough to debug from
+        if (++mismatches <= 10) {
+            std::printf("%s: %s gave %d, <cctype> %d for \"", kernelName(kernel), what, actual, expected);
+            for (unsigned char c : input)
+                std::printf(c >= 0x20 && c < 0x7F ? "%c" : "\\x%02x", c);
+            std::printf("\"\n");
+        }
+    }
+};
+
+void compareValidators(const std::string& input, CharClass::Kernel kernel, Report& report)
+{
+    report.check(legacy::isValidUsername(input), Validator::isValidUsername(input), "isValidUsername", input, kernel);
+    report.check(legacy::hasNoSpaces(input), Validator::hasNoSpaces(input), "hasNoSpaces", input, kernel);
+    report.check(legacy::isValidPassword(input), Validator::isValidPassword(input), "isValidPassword", input, kernel);
+    report.check(legacy::isPasswordStrong(input), Validator::isPasswordStrong(input), "isPasswordStrong", input, kernel);
+    report.check(legacy::isValidEmail(input), Validator::isValidEmail(input), "isValidEmail", input, kernel);
+    report.check(legacy::containsOnlyAlphanumeric(input), Validator::containsOnlyAlphanumeric(input),
+        "containsOnlyAlphanumeric", input, kernel);
+}
+
+void comparePrimitives(const std::string& input, uint8_t classes, CharClass::Kernel kernel, Report& report)
+{
+    size_t expectedFirst = input.size();
+    uint8_t expectedPresent = 0;
+
+    for (size_t i = 0; i < input.size(); ++i) {
+        const uint8_t cls = legacy::classOf(static_cast<unsigned char>(input[i]));
+        expectedPresent |= cls;
+        if (expectedFirst == input.size() && !(cls & classes))
+            expectedFirst = i;
+    }
+
+    report.check(true, CharClass::findFirstNotIn(input.data(), input.size(), classes) == expectedFirst,
+        "findFirstNotIn", input, kernel);
+    report.check(true, CharClass::classesPresent(input.data(), input.size()) == expectedPresent,
+        "classesPresent", input, kernel);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const size_t inputs = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    const uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20241;
+
+    Report report;
+
+    for (int k = CharClass::SCALAR; k <= CharClass::bestSupportedKernel(); ++k) {
+        const CharClass::Kernel kernel = static_cast<CharClass::Kernel>(k);
+        CharClass::setKernel(kernel);
+
+        // The same inputs for every kernel
+        std::mt19937_64 random(seed);
+        std::uniform_int_distribution<int> anyClasses(1, CharClass::OTHER - 1);
+
+        std::vector<std::string> column;
+        for (size_t i = 0; i < inputs; ++i) {
+            std::string input = randomInput(random);
+            compareValidators(input, kernel, report);
+            comparePrimitives(input, static_cast<uint8_t>(anyClasses(random)), kernel, report);
+            column.push_back(std::move(input));
+        }
+
+        // The batch path must agree with the single-value one
+        const std::vector<std::string_view> views(column.begin(), column.end());
+        std::vector<uint8_t> valid;
+        Validator::validateColumn(Validator::Field::EMAIL, views, valid);
+        for (size_t i = 0; i < column.size(); ++i)
+            report.check(legacy::isValidEmail(column[i]), valid[i] != 0, "validateColumn", column[i], kernel);
+
+        std::printf("%s: %zu inputs checked\n", kernelName(kernel), inputs);
+    }
+
+    CharClass::setKernel(CharClass::bestSupportedKernel());
+
+    if (report.mismatches != 0) {
+        std::printf("%zu mismatches\n", report.mismatches);
+        return 1;
+    }
+
+    return 0;
+}
@@ -5,8 +5,20 @@
 #include <fstream>
 #include <iomanip>
 #include <ctime>
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <new>
 #include "header_functions.h"  // Your original header name
 
+// Utilities shared with V2. They use no V2 types, so V1 compiles them as is.
+#include "../V2_Guardian_OOP Refactor/include/CharClass.h"  // Shared validation kernels
+#include "../V2_Guardian_OOP Refactor/include/CsvTokenizer.h"  // Shared record tokenizer
+#include "../V2_Guardian_OOP Refactor/include/Timestamp.h"  // Shared epoch timestamps
+
 /*
 * ==================== Screen Utilities ====================
 */
@@ -210,13 +222,8 @@ bool IsValidEmail(const std::string& email)
 		return false;
 
 	// Check for valid characters before @
-	for (size_t i = 0; i < atPos; ++i)
-	{
-		if (!isalnum(email[i]) && email[i] != '.' && email[i] != '_' && email[i] != '-')
-			return false;
-	}
-
-	return true;
+	return CharClass::findFirstNotIn(email.data(), atPos,
+		CharClass::ALNUM | CharClass::UNDERSCORE | CharClass::DOT_DASH) == atPos;
 }
 
 bool IsValidUsername(const std::string& username)
@@ -224,19 +231,14 @@ bool IsValidUsername(const std::string& username)
 	if (username.empty())
 		return false;
 
-	if (!isalpha(username[0]))
+	if (!(CharClass::classOf(username[0]) & CharClass::ALPHA))
 		return false;
 
 	if (username.length() < 3 || username.length() > 20)
 		return false;
 
-	for (char c : username)
-	{
-		if (!isalnum(c) && c != '_')
-			return false;
-	}
-
-	return true;
+	return CharClass::findFirstNotIn(username.data(), username.length(),
+		CharClass::ALNUM | CharClass::UNDERSCORE) == username.length();
 }
 
 bool IsValidPassword(const std::string& password)
@@ -244,21 +246,15 @@ bool IsValidPassword(const std::string& password)
 	if (password.length() < 8 || password.length() > 50)
 		return false;
 
-	bool hasUpper = false;
-	bool hasLower = false;
-	bool hasDigit = false;
-	bool hasSpecial = false;
+	unsigned char present = CharClass::classesPresent(password.data(), password.length());
 
-	for (char c : password)
-	{
-		if (isupper(c))        hasUpper = true;
-		else if (islower(c))   hasLower = true;
-		else if (isdigit(c))   hasDigit = true;
-		else if (!isspace(c))  hasSpecial = true;
-		else return false; // spaces not allowed
-	}
+	if (present & CharClass::SPACE)
+		return false; // spaces not allowed
 
-	return hasUpper && hasLower && hasDigit && hasSpecial;
+	return (present & CharClass::UPPER)
+		&& (present & CharClass::LOWER)
+		&& (present & CharClass::DIGIT)
+		&& (present & (CharClass::UNDERSCORE | CharClass::DOT_DASH | CharClass::OTHER));
 }
 
 std::string GetValidEmail()
@@ -334,49 +330,30 @@ void Login(User& user)
 	std::cout << "Enter Password: ";
 	std::getline(std::cin, user.password);
 
-	std::ifstream file("users.txt");
+	UserIndex& index = GetUserIndex();
 
-	if (!file)
+	if (index.records.empty())
 	{
 		ShowErrorMessage("No users found. Please register first.");
 		PauseScreen();
 		return;
 	}
 
-	std::string line;
+	User found;
 
-	while (std::getline(file, line))
+	if (FindUserByUsername(user.username, found) && user.password == found.password)
 	{
-		std::stringstream ss(line);
-		std::string id, email, username, password, createdAt, lastLogin;
-
-		std::getline(ss, id, ',');
-		std::getline(ss, email, ',');
-		std::getline(ss, username, ',');
-		std::getline(ss, password, ',');
-		std::getline(ss, createdAt, ',');
-		std::getline(ss, lastLogin, ',');
-
-		if (user.username == username && user.password == password)
-		{
-			user.id = std::stoi(id);
-			user.email = email;
-			user.createdAt = createdAt;
-			user.lastLogin = lastLogin;
-
-			file.close();
+		user = found;
 
-			// Update last login
-			UpdateLastLogin(user);
+		// Update last login
+		UpdateLastLogin(user);
 
-			ShowSuccessMessage("Login successful!");
-			PauseScreen();
-			UserScreen(user);
-			return;
-		}
+		ShowSuccessMessage("Login successful!");
+		PauseScreen();
+		UserScreen(user);
+		return;
 	}
 
-	file.close();
 	ShowErrorMessage("Invalid username or password.");
 	PauseScreen();
 }
@@ -455,34 +432,37 @@ void DisplayUser(const User& user)
 	std::cout << "  Email:           " << user.email << std::endl;
 	std::cout << "  Username:        " << user.username << std::endl;
 	std::cout << "  Password:        " << std::string(user.password.length(), '*') << " (hidden)" << std::endl;
-	std::cout << "  Account Created: " << user.createdAt << std::endl;
-	std::cout << "  Last Login:      " << user.lastLogin << std::endl;
+	std::cout << "  Account Created: " << Timestamp::format(user.createdAt) << std::endl;
+	std::cout << "  Last Login:      " << Timestamp::format(user.lastLogin) << std::endl;
 	std::cout << "\n=======================================" << std::endl;
 }
 
 bool CreateUser(User& user)
 {
-	std::ofstream file("users.txt", std::ios::app);
+	// Another instance may have registered the same name since the caller
+	// checked, so check again and take the id while holding the lock
+	LockUserFiles();
 
-	if (!file)
+	if (IndexHasEmail(user.email) || IndexHasUsername(user.username))
 	{
-		std::cerr << "Error: Can't open file for writing." << std::endl;
+		UnlockUserFiles();
 		return false;
 	}
 
 	user.id = GetLastId() + 1;
-	user.createdAt = GetCurrentDateTime();
+	user.createdAt = Timestamp::now();
 	user.lastLogin = user.createdAt;
 
-	file << user.id << ","
-		<< user.email << ","
-		<< user.username << ","
-		<< user.password << ","
-		<< user.createdAt << ","
-		<< user.lastLogin << '\n';
+	bool appended = AppendLogEntry("U," + FormatUserRecord(user));
+	if (appended)
+		IndexUser(user);
 
-	file.close();
-	return true;
+	UnlockUserFiles();
+
+	if (!appended)
+		std::cerr << "Error: Can't open file for writing." << std::endl;
+
+	return appended;
 }
 
 bool UserExists(const User& user)
@@ -492,109 +472,39 @@ bool UserExists(const User& user)
 
 bool EmailExists(const std::string& email)
 {
-	std::ifstream file("users.txt");
-
-	if (!file)
-		return false;
-
-	std::string line;
-
-	while (std::getline(file, line))
-	{
-		std::stringstream ss(line);
-		std::string id, fileEmail;
-
-		std::getline(ss, id, ',');
-		std::getline(ss, fileEmail, ',');
-
-		if (email == fileEmail)
-		{
-			file.close();
-			return true;
-		}
-	}
+	bool locked = LockUserFilesForRead();
+	bool exists = IndexHasEmail(email);
+	if (locked)
+		UnlockUserFiles();
 
-	file.close();
-	return false;
+	return exists;
 }
 
 bool UsernameExists(const std::string& username)
 {
-	std::ifstream file("users.txt");
+	bool locked = LockUserFilesForRead();
+	bool exists = IndexHasUsername(username);
+	if (locked)
+		UnlockUserFiles();
 
-	if (!file)
-		return false;
-
-	std::string line;
-
-	while (std::getline(file, line))
-	{
-		std::stringstream ss(line);
-		std::string id, email, fileUsername;
-
-		std::getline(ss, id, ',');
-		std::getline(ss, email, ',');
-		std::getline(ss, fileUsername, ',');
-
-		if (username == fileUsername)
-		{
-			file.close();
-			return true;
-		}
-	}
-
-	file.close();
-	return false;
+	return exists;
 }
 
 int GetLastId()
 {
-	std::ifstream file("users.txt");
-
-	if (!file)
-		return 0;
-
-	std::string line;
-	std::string lastId = "0";
-
-	while (std::getline(file, line))
-	{
-		std::stringstream ss(line);
-		std::getline(ss, lastId, ',');
-	}
-
-	file.close();
-	return std::stoi(lastId);
+	return GetUserIndex().maxId;
 }
 
 std::string GetCurrentDateTime()
 {
-	time_t now = time(0);
-	tm ltm;
-
-	// Use safe version for Windows
-#ifdef _WIN32
-	localtime_s(&ltm, &now);
-#else
-	localtime_r(&now, &ltm);
-#endif
-
-	std::ostringstream oss;
-	oss << std::setfill('0')
-		<< std::setw(4) << 1900 + ltm.tm_year << "-"
-		<< std::setw(2) << 1 + ltm.tm_mon << "-"
-		<< std::setw(2) << ltm.tm_mday << " "
-		<< std::setw(2) << ltm.tm_hour << ":"
-		<< std::setw(2) << ltm.tm_min << ":"
-		<< std::setw(2) << ltm.tm_sec;
-
-	return oss.str();
+	// Formatted once per second; 19 characters fit the small-string buffer
+	return std::string(Timestamp::nowText());
 }
 
 void UpdateLastLogin(User& user)
 {
-	user.lastLogin = GetCurrentDateTime();
-	RewriteUser(user, user.email);
+	user.lastLogin = Timestamp::now();
+	RewriteUser(user);
 }
 
 void UpdateUser(User& updatedUser)
@@ -658,7 +568,7 @@ void UpdateUser(User& updatedUser)
 		return;
 	}
 
-	RewriteUser(updatedUser, oldEmail);
+	RewriteUser(updatedUser);
 	ShowSuccessMessage("Information updated successfully!");
 }
 
@@ -699,109 +609,1224 @@ void ChangePassword(User& user)
 	}
 
 	user.password = newPassword;
-	RewriteUser(user, user.email);
+	RewriteUser(user);
 	ShowSuccessMessage("Password changed successfully!");
 }
 
-void RewriteUser(const User& updatedUser, const std::string& oldEmail)
+void RewriteUser(const User& updatedUser)
 {
-	std::ifstream in("users.txt");
-	std::ofstream out("temp.txt");
+	// Index before unlocking, so a compaction on unlock sees the change
+	LockUserFiles();
 
-	if (!in || !out)
-	{
+	bool appended = AppendLogEntry("U," + FormatUserRecord(updatedUser));
+	if (appended)
+		IndexUser(updatedUser);
+
+	UnlockUserFiles();
+
+	if (!appended)
 		std::cerr << "Error: Can't open file." << std::endl;
+}
+
+void DeleteUser(const User& deletedUser)
+{
+	LockUserFiles();
+
+	bool appended = AppendLogEntry("D," + std::to_string(deletedUser.id));
+	if (appended)
+		UnindexUser(deletedUser.id);
+
+	UnlockUserFiles();
+
+	if (appended)
+		ShowSuccessMessage("Account deleted successfully.");
+	else
+		ShowErrorMessage("Failed to delete account. Please try again.");
+}
+
+/*
+* ==================== Index Operations ====================
+*/
+
+const size_t MIN_LOOKUP_SLOTS = 16;          // lookup tables are powers of two
+const size_t MIN_POOL_GARBAGE = 1 << 16;     // pool bytes freed before compacting
+
+static int RecordId(const UserIndex&, const UserRecord& record)
+{
+	return record.id;
+}
+
+static std::string_view RecordEmail(const UserIndex& index, const UserRecord& record)
+{
+	return std::string_view(index.pool).substr(record.offset, record.emailLength);
+}
+
+static std::string_view RecordUsername(const UserIndex& index, const UserRecord& record)
+{
+	return std::string_view(index.pool).substr(record.offset + record.emailLength, record.usernameLength);
+}
+
+static std::string_view RecordPassword(const UserIndex& index, const UserRecord& record)
+{
+	return std::string_view(index.pool).substr(
+		record.offset + record.emailLength + record.usernameLength, record.passwordLength);
+}
+
+static void LoadRecord(const UserIndex& index, const UserRecord& record, User& user)
+{
+	std::string_view email = RecordEmail(index, record);
+	std::string_view username = RecordUsername(index, record);
+	std::string_view password = RecordPassword(index, record);
+
+	user.id = record.id;
+	user.email.assign(email.data(), email.size());
+	user.username.assign(username.data(), username.size());
+	user.password.assign(password.data(), password.size());
+	user.createdAt = record.createdAt;
+	user.lastLogin = record.lastLogin;
+}
+
+static size_t HashKey(int id)
+{
+	return static_cast<uint32_t>(id) * 2654435761u;
+}
+
+static size_t HashKey(std::string_view key)
+{
+	return Checksum(key);
+}
+
+// Slot holding key, or the empty slot where it belongs (linear probing)
+template <typename Key, typename KeyOf>
+static size_t ProbeSlot(const UserIndex& index, const std::vector<uint32_t>& table,
+	Key key, KeyOf keyOf)
+{
+	const size_t mask = table.size() - 1;
+	size_t slot = HashKey(key) & mask;
+
+	while (table[slot] != 0 && keyOf(index, index.records[table[slot] - 1]) != key)
+		slot = (slot + 1) & mask;
+
+	return slot;
+}
+
+// Position + 1 of the record with this key, 0 if there is none
+template <typename Key, typename KeyOf>
+static uint32_t FindRecord(const UserIndex& index, const std::vector<uint32_t>& table,
+	Key key, KeyOf keyOf)
+{
+	if (table.empty())
+		return 0;
+
+	return table[ProbeSlot(index, table, key, keyOf)];
+}
+
+// Backward-shift deletion, so probes never need tombstones
+template <typename KeyOf>
+static void EraseSlot(const UserIndex& index, std::vector<uint32_t>& table, size_t hole, KeyOf keyOf)
+{
+	const size_t mask = table.size() - 1;
+
+	for (size_t next = (hole + 1) & mask; table[next] != 0; next = (next + 1) & mask)
+	{
+		size_t home = HashKey(keyOf(index, index.records[table[next] - 1])) & mask;
+
+		// Shift next back unless the hole lies before its home slot
+		if (((next - home) & mask) >= ((next - hole) & mask))
+		{
+			table[hole] = table[next];
+			hole = next;
+		}
+	}
+
+	table[hole] = 0;
+}
+
+// Point key's slot from one position to another (0 erases it). Corrupt
+// files can repeat a key; a slot already taken over is left alone.
+template <typename Key, typename KeyOf>
+static void MoveSlot(const UserIndex& index, std::vector<uint32_t>& table,
+	Key key, KeyOf keyOf, uint32_t from, uint32_t to)
+{
+	size_t slot = ProbeSlot(index, table, key, keyOf);
+
+	if (table[slot] != from)
 		return;
+
+	if (to == 0)
+		EraseSlot(index, table, slot, keyOf);
+	else
+		table[slot] = to;
+}
+
+static void RebuildLookups(UserIndex& index, size_t slots)
+{
+	index.byId.assign(slots, 0);
+	index.byEmail.assign(slots, 0);
+	index.byUsername.assign(slots, 0);
+
+	for (uint32_t i = 0; i < index.records.size(); ++i)
+	{
+		const UserRecord& record = index.records[i];
+
+		index.byId[ProbeSlot(index, index.byId, record.id, RecordId)] = i + 1;
+		index.byEmail[ProbeSlot(index, index.byEmail, RecordEmail(index, record), RecordEmail)] = i + 1;
+		index.byUsername[ProbeSlot(index, index.byUsername, RecordUsername(index, record), RecordUsername)] = i + 1;
 	}
+}
 
-	std::string line;
+// Copy live strings into a fresh pool once most of it is garbage
+static void CompactPool(UserIndex& index)
+{
+	std::string pool;
+	pool.reserve(index.pool.size() - index.poolGarbage);
 
-	while (std::getline(in, line))
+	for (UserRecord& record : index.records)
 	{
-		std::stringstream ss(line);
-		std::string id, email;
+		size_t length = record.emailLength + record.usernameLength + record.passwordLength;
+
+		uint32_t offset = static_cast<uint32_t>(pool.size());
+		pool.append(index.pool, record.offset, length);
+		record.offset = offset;
+	}
+
+	index.pool.swap(pool);
+	index.poolGarbage = 0;
+}
+
+UserIndex& GetUserIndex()
+{
+	static UserIndex index;
+
+	if (!index.loaded)
+		LoadUserIndex(index);
 
-		std::getline(ss, id, ',');
-		std::getline(ss, email, ',');
+	return index;
+}
+
+void LoadUserIndex(UserIndex& index)
+{
+	index.loaded = true;
+
+	// Loading from scratch, so there is nothing to catch up with
+	UserLog& log = GetUserLog();
+	log.synced = false;
+	LockUserFiles();
+
+	RecoverSnapshot();
+
+	// Another instance already loaded these files: copy its image and
+	// replay only what was logged after it was published
+	uint64_t logOffset = 0;
+	bool attached = AttachSharedIndex(index, logOffset);
+	size_t replayed = 0;
+
+	if (attached)
+	{
+		replayed = ReplayLog("users.log", logOffset);
+	}
+	else
+	{
+		std::ifstream file("users.txt");
 
-		if (oldEmail == email)
+		if (file)
 		{
-			out << updatedUser.id << ','
-				<< updatedUser.email << ','
-				<< updatedUser.username << ','
-				<< updatedUser.password << ','
-				<< updatedUser.createdAt << ','
-				<< updatedUser.lastLogin << '\n';
+			std::string line;
+			User user;
+
+			while (std::getline(file, line))
+			{
+				if (ParseUserRecord(line, user))
+					IndexUser(user);
+			}
+
+			file.close();
 		}
-		else
+
+		// An older log left behind by an interrupted compaction replays first
+		replayed = ReplayLog("users.log.compacting");
+		replayed += ReplayLog("users.log");
+	}
+
+	// Fold anything recovered from the logs into a fresh snapshot before
+	// accepting new writes, so every run starts from a clean log.
+	log.entries = replayed;
+
+	if (!attached && replayed > 0 && WriteSnapshot(SnapshotUsers()))
+	{
+		remove("users.log.compacting");
+		std::ofstream truncate("users.log", std::ios::trunc);
+		log.entries = 0;
+	}
+
+	// Reopen even on a reload: the old stream may point at a rotated file
+	log.out.close();
+	log.out.clear();
+	log.out.open("users.log", std::ios::app);
+
+	if (!attached)
+		PublishSharedIndex(index);
+
+	log.synced = true;
+	UnlockUserFiles();
+}
+
+void IndexUser(const User& user)
+{
+	UserIndex& index = GetUserIndex();
+
+	// Timestamp-only rewrites (every login) keep the pooled strings
+	uint32_t existing = FindRecord(index, index.byId, user.id, RecordId);
+
+	if (existing != 0)
+	{
+		UserRecord& record = index.records[existing - 1];
+
+		if (RecordEmail(index, record) == user.email
+			&& RecordUsername(index, record) == user.username
+			&& RecordPassword(index, record) == user.password)
 		{
-			out << line << '\n';
+			record.createdAt = user.createdAt;
+			record.lastLogin = user.lastLogin;
+			return;
 		}
+
+		// An update may change email or username, so drop the old keys first
+		UnindexUser(user.id);
 	}
 
-	in.close();
-	out.close();
+	UserRecord record;
+	record.id = user.id;
+	record.offset = static_cast<uint32_t>(index.pool.size());
+	record.emailLength = static_cast<uint16_t>(user.email.size());
+	record.usernameLength = static_cast<uint16_t>(user.username.size());
+	record.passwordLength = static_cast<uint16_t>(user.password.size());
+	record.createdAt = user.createdAt;
+	record.lastLogin = user.lastLogin;
+
+	index.pool += user.email;
+	index.pool += user.username;
+	index.pool += user.password;
 
-	remove("users.txt");
-	rename("temp.txt", "users.txt");
+	if ((index.records.size() + 1) * 2 > index.byId.size())
+		RebuildLookups(index, std::max<size_t>(MIN_LOOKUP_SLOTS, index.byId.size() * 2));
+
+	index.records.push_back(record);
+	const uint32_t position = static_cast<uint32_t>(index.records.size());
+
+	index.byId[ProbeSlot(index, index.byId, record.id, RecordId)] = position;
+	index.byEmail[ProbeSlot(index, index.byEmail, RecordEmail(index, record), RecordEmail)] = position;
+	index.byUsername[ProbeSlot(index, index.byUsername, RecordUsername(index, record), RecordUsername)] = position;
+
+	if (user.id > index.maxId)
+		index.maxId = user.id;
 }
 
-void DeleteUser(const User& deletedUser)
+void UnindexUser(int id)
 {
-	std::ifstream in("users.txt");
-	std::ofstream out("temp.txt");
+	UserIndex& index = GetUserIndex();
 
-	if (!in || !out)
-	{
-		std::cerr << "Error: Can't open file." << std::endl;
+	uint32_t position = FindRecord(index, index.byId, id, RecordId);
+	if (position == 0)
 		return;
-	}
 
-	std::string line;
+	const UserRecord& record = index.records[position - 1];
 
-	while (std::getline(in, line))
+	MoveSlot(index, index.byId, record.id, RecordId, position, 0);
+	MoveSlot(index, index.byEmail, RecordEmail(index, record), RecordEmail, position, 0);
+	MoveSlot(index, index.byUsername, RecordUsername(index, record), RecordUsername, position, 0);
+
+	index.poolGarbage += record.emailLength + record.usernameLength + record.passwordLength;
+
+	// Keep records dense: the last record takes over the freed position
+	const uint32_t last = static_cast<uint32_t>(index.records.size());
+
+	if (position != last)
 	{
-		std::stringstream ss(line);
-		std::string id, email;
+		const UserRecord& moved = index.records[last - 1];
 
-		std::getline(ss, id, ',');
-		std::getline(ss, email, ',');
+		MoveSlot(index, index.byId, moved.id, RecordId, last, position);
+		MoveSlot(index, index.byEmail, RecordEmail(index, moved), RecordEmail, last, position);
+		MoveSlot(index, index.byUsername, RecordUsername(index, moved), RecordUsername, last, position);
 
-		if (deletedUser.email != email)
-			out << line << '\n';
+		index.records[position - 1] = moved;
 	}
 
-	in.close();
-	out.close();
+	index.records.pop_back();
 
-	remove("users.txt");
+	if (index.poolGarbage > MIN_POOL_GARBAGE && index.poolGarbage * 2 > index.pool.size())
+		CompactPool(index);
+}
 
-	if (rename("temp.txt", "users.txt") == 0)
-		ShowSuccessMessage("Account deleted successfully.");
-	else
-		ShowErrorMessage("Failed to delete account. Please try again.");
+bool FindUserByUsername(const std::string& username, User& user)
+{
+	bool locked = LockUserFilesForRead();
+
+	const UserIndex& index = GetUserIndex();
+
+	uint32_t position = FindRecord(index, index.byUsername, std::string_view(username), RecordUsername);
+	if (position != 0)
+		LoadRecord(index, index.records[position - 1], user);
+
+	if (locked)
+		UnlockUserFiles();
+
+	return position != 0;
+}
+
+bool IndexHasEmail(std::string_view email)
+{
+	const UserIndex& index = GetUserIndex();
+	return FindRecord(index, index.byEmail, email, RecordEmail) != 0;
+}
+
+bool IndexHasUsername(std::string_view username)
+{
+	const UserIndex& index = GetUserIndex();
+	return FindRecord(index, index.byUsername, username, RecordUsername) != 0;
+}
+
+void ReserveUserIndex(size_t records)
+{
+	UserIndex& index = GetUserIndex();
+
+	index.records.reserve(records);
+
+	size_t slots = MIN_LOOKUP_SLOTS;
+	while (slots < records * 2)
+		slots *= 2;
+
+	if (slots > index.byId.size())
+		RebuildLookups(index, slots);
 }
 
 /*
-* ==================== Main ====================
+* ==================== Shared Index ====================
 */
 
-int main()
+const char SHARED_INDEX_MAGIC[8] = { 'C', 'E', 'V', '1', 'I', 'D', 'X', 0 };
+const uint32_t SHARED_INDEX_VERSION = 1;
+
+static SharedIndexHeader* SharedHeader()
 {
-	while (true)
+	return static_cast<SharedIndexHeader*>(GetUserLog().sharedHeader.data());
+}
+
+static std::string SharedImageName(uint64_t generation)
+{
+	return GetUserLog().sharedName + "-" + std::to_string(generation);
+}
+
+// Find or create this directory's header segment, once per process.
+// Runs under users.lock, so two instances never create it together.
+static void OpenSharedIndex()
+{
+	UserLog& log = GetUserLog();
+
+	if (!log.sharedName.empty())
+		return;
+
+	std::error_code error;
+	const std::string directory = std::filesystem::absolute(".", error).string();
+
+	char name[32];
+	snprintf(name, sizeof(name), "cev1-%08x", Checksum(directory));
+	log.sharedName = name;
+
+	if (log.instances.open("users.instances"))
+		log.instances.lock_shared();
+
+	if (log.sharedHeader.open(name))
 	{
-		User user;
-		InitialScreen();
-		int choice = InitialChoice();
+		const SharedIndexHeader* header = SharedHeader();
 
-		if (choice == 3)
-			break;
+		if (log.sharedHeader.size() >= sizeof(SharedIndexHeader)
+			&& std::equal(std::begin(SHARED_INDEX_MAGIC), std::end(SHARED_INDEX_MAGIC), header->magic)
+			&& header->version == SHARED_INDEX_VERSION)
+			return;
 
-		LoginOrRegister(user, choice);
+		// Another layout, or a creator that died half way: start a new one
+		log.sharedHeader.close();
+		SharedMemory::remove(name);
 	}
 
-	std::cout << "\nThank you for using Blog System v1.0!" << std::endl;
-	std::cout << "Goodbye!" << std::endl;
+	if (!log.sharedHeader.create(name, sizeof(SharedIndexHeader)))
+		return;
 
-	return 0;
-}
\ No newline at end of file
+	SharedIndexHeader* header = new (log.sharedHeader.data()) SharedIndexHeader();
+	std::copy(std::begin(SHARED_INDEX_MAGIC), std::end(SHARED_INDEX_MAGIC), header->magic);
+	header->version = SHARED_INDEX_VERSION;
+}
+
+bool AttachSharedIndex(UserIndex& index, uint64_t& logOffset)
+{
+	SharedIndexHeader* header = SharedHeader();
+	SharedIndexImage image;
+
+	if (!header || !header->image.tryLoad(image) || image.generation == 0)
+		return false;
+
+	// Only usable while the files still hold what the image was built from
+	AtomicFile::Stamp changes = AtomicFile::stamp("users.log");
+
+	if (AtomicFile::stamp("users.txt") != image.snapshot || !changes.exists || !image.log.exists
+		|| changes.identity != image.log.identity || changes.size < image.log.size)
+		return false;
+
+	const size_t tableBytes = image.slots * sizeof(uint32_t);
+	const size_t recordBytes = image.records * sizeof(UserRecord);
+
+	SharedMemory segment;
+	if (!segment.open(SharedImageName(image.generation))
+		|| segment.size() < recordBytes + 3 * tableBytes + image.poolSize)
+		return false;
+
+	const char* data = static_cast<const char*>(segment.data());
+	const UserRecord* records = reinterpret_cast<const UserRecord*>(data);
+	const uint32_t* tables = reinterpret_cast<const uint32_t*>(data + recordBytes);
+
+	index.records.assign(records, records + image.records);
+	index.byId.assign(tables, tables + image.slots);
+	index.byEmail.assign(tables + image.slots, tables + 2 * image.slots);
+	index.byUsername.assign(tables + 2 * image.slots, tables + 3 * image.slots);
+	index.pool.assign(data + recordBytes + 3 * tableBytes, image.poolSize);
+	index.poolGarbage = image.poolGarbage;
+	index.maxId = image.maxId;
+
+	logOffset = image.log.size;
+	return true;
+}
+
+// Copy the index into a new segment, then point the header at it.
+// Images are never changed once published, so a reader copying the old
+// one is unaffected; the old name is unlinked and goes away once its
+// last reader unmaps it.
+void PublishSharedIndex(const UserIndex& index)
+{
+	UserLog& log = GetUserLog();
+	SharedIndexHeader* header = SharedHeader();
+
+	if (!header)
+		return;
+
+	SharedIndexImage previous;
+	if (!header->image.tryLoad(previous))
+		previous = SharedIndexImage();
+
+	log.out.flush();
+
+	SharedIndexImage image;
+	image.generation = previous.generation + 1;
+	image.snapshot = AtomicFile::stamp("users.txt");
+	image.log = AtomicFile::stamp("users.log");
+	image.records = index.records.size();
+	image.slots = index.byId.size();
+	image.poolSize = index.pool.size();
+	image.poolGarbage = index.poolGarbage;
+	image.maxId = index.maxId;
+
+	const size_t tableBytes = image.slots * sizeof(uint32_t);
+	const size_t recordBytes = image.records * sizeof(UserRecord);
+	const std::string name = SharedImageName(image.generation);
+
+	SharedMemory::remove(name);  // left by a publisher that died
+
+	SharedMemory segment;
+	if (!segment.create(name, recordBytes + 3 * tableBytes + image.poolSize + 1))
+		return;
+
+	char* data = static_cast<char*>(segment.data());
+	std::copy(index.records.begin(), index.records.end(), reinterpret_cast<UserRecord*>(data));
+
+	uint32_t* tables = reinterpret_cast<uint32_t*>(data + recordBytes);
+	std::copy(index.byId.begin(), index.byId.end(), tables);
+	std::copy(index.byEmail.begin(), index.byEmail.end(), tables + image.slots);
+	std::copy(index.byUsername.begin(), index.byUsername.end(), tables + 2 * image.slots);
+	std::copy(index.pool.begin(), index.pool.end(), data + recordBytes + 3 * tableBytes);
+
+	header->image.store(image);
+
+	if (previous.generation != 0)
+		SharedMemory::remove(SharedImageName(previous.generation));
+
+	// Keep a handle: on Windows the segment lives only as long as one does
+	log.sharedImage.open(name);
+}
+
+// Drop this instance's hold on users.instances; if nobody else holds it,
+// no instance is left to read the segments, so unlink them. users.lock
+// keeps a new instance from attaching in between.
+static void DetachSharedIndex(UserLog& log)
+{
+	if (log.sharedName.empty() || !log.instances.isOpen())
+		return;
+
+	log.lock.lock();
+	log.instances.unlock_shared();
+
+	if (log.instances.try_lock())
+	{
+		const SharedIndexHeader* header = static_cast<const SharedIndexHeader*>(log.sharedHeader.data());
+		SharedIndexImage image;
+
+		if (header && header->image.tryLoad(image) && image.generation != 0)
+			SharedMemory::remove(log.sharedName + "-" + std::to_string(image.generation));
+
+		SharedMemory::remove(log.sharedName);
+		log.instances.unlock();
+	}
+
+	log.instances.close();
+	log.sharedImage.close();
+	log.sharedHeader.close();
+	log.sharedName.clear();
+
+	if (log.lockDepth == 0)
+		log.lock.unlock();
+}
+
+/*
+* ==================== Log Operations ====================
+*/
+
+const size_t LOG_COMPACT_THRESHOLD = 1000;
+
+UserLog::~UserLog()
+{
+	if (compactor.joinable())
+		compactor.join();
+
+	DetachSharedIndex(*this);
+}
+
+UserLog& GetUserLog()
+{
+	static UserLog log;
+	return log;
+}
+
+std::string FormatUserRecord(const User& user)
+{
+	std::string record = std::to_string(user.id);
+
+	for (const std::string* field : { &user.email, &user.username, &user.password })
+	{
+		record += ',';
+		CsvTokenizer::appendField(record, *field);
+	}
+
+	// Timestamps never need quoting; an unset one stays an empty field
+	for (int64_t timestamp : { user.createdAt, user.lastLogin })
+	{
+		record += ',';
+
+		if (timestamp != 0)
+		{
+			size_t end = record.size();
+			record.resize(end + Timestamp::TEXT_LENGTH);
+			Timestamp::formatTo(timestamp, &record[end]);
+		}
+	}
+
+	return record;
+}
+
+// The whole field must be the number: from_chars alone accepts "12abc"
+static bool ParseId(std::string_view text, int& id)
+{
+	auto parsed = std::from_chars(text.data(), text.data() + text.size(), id);
+	return parsed.ec == std::errc() && parsed.ptr == text.data() + text.size();
+}
+
+bool ParseUserRecord(std::string_view line, User& user)
+{
+	CsvTokenizer fields;
+
+	// Skip blank or malformed rows; older rows may lack the timestamps
+	if (!fields.tokenize(line) || fields.size() < 4)
+		return false;
+
+	if (!ParseId(fields[0], user.id))
+		return false;
+
+	// The index stores string lengths in 16 bits
+	if (fields[1].size() > UINT16_MAX || fields[2].size() > UINT16_MAX || fields[3].size() > UINT16_MAX)
+		return false;
+
+	// assign() reuses the strings' capacity when user is recycled
+	user.email.assign(fields[1].data(), fields[1].size());
+	user.username.assign(fields[2].data(), fields[2].size());
+	user.password.assign(fields[3].data(), fields[3].size());
+
+	// An unreadable timestamp is treated as unknown rather than losing the account
+	if (!Timestamp::parse(fields.field(4), user.createdAt))
+		user.createdAt = 0;
+	if (!Timestamp::parse(fields.field(5), user.lastLogin))
+		user.lastLogin = 0;
+
+	return true;
+}
+
+unsigned int Checksum(std::string_view data)
+{
+	// 32-bit FNV-1a
+	unsigned int hash = 2166136261u;
+
+	for (unsigned char c : data)
+	{
+		hash ^= c;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+bool AppendLogEntry(const std::string& payload)
+{
+	GetUserIndex();  // make sure startup recovery has run
+
+	LockUserFiles();
+
+	UserLog& log = GetUserLog();
+
+	std::ostringstream checksum;
+	checksum << std::hex << std::setw(8) << std::setfill('0') << Checksum(payload);
+
+	log.out << payload << ',' << checksum.str() << '\n';
+	log.out.flush();
+
+	bool appended = static_cast<bool>(log.out);
+	log.changed = log.changed || appended;
+
+	// Compaction waits for the outermost unlock: the caller indexes the
+	// entry after appending it, and the snapshot must include it
+	if (appended)
+		++log.entries;
+
+	UnlockUserFiles();
+	return appended;
+}
+
+size_t ReplayLog(const std::string& path, uint64_t offset)
+{
+	std::ifstream file(path, std::ios::binary);
+
+	if (!file || !file.seekg(static_cast<std::streamoff>(offset)))
+		return 0;
+
+	std::string line;
+	User user;
+	size_t replayed = 0;
+
+	while (std::getline(file, line))
+	{
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+
+		size_t comma = line.rfind(',');
+		if (comma == std::string::npos || line.size() - comma - 1 != 8)
+			break;
+
+		const std::string_view payload(line.data(), comma);
+
+		char* end = nullptr;
+		unsigned long stored = strtoul(line.c_str() + comma + 1, &end, 16);
+
+		// A checksum mismatch means a torn write at the tail: stop there
+		if (*end != '\0' || Checksum(payload) != stored)
+			break;
+
+		if (payload.compare(0, 2, "U,") == 0)
+		{
+			if (ParseUserRecord(payload.substr(2), user))
+				IndexUser(user);
+		}
+		else if (payload.compare(0, 2, "D,") == 0)
+		{
+			int id = 0;
+			if (ParseId(payload.substr(2), id))
+				UnindexUser(id);
+		}
+
+		++replayed;
+	}
+
+	file.close();
+	return replayed;
+}
+
+std::vector<User> SnapshotUsers()
+{
+	const UserIndex& index = GetUserIndex();
+
+	std::vector<User> users(index.records.size());
+
+	for (size_t i = 0; i < users.size(); ++i)
+		LoadRecord(index, index.records[i], users[i]);
+
+	std::sort(users.begin(), users.end(),
+		[](const User& a, const User& b) { return a.id < b.id; });
+
+	return users;
+}
+
+bool WriteSnapshot(const std::vector<User>& users)
+{
+	std::string data;
+
+	for (const User& user : users)
+	{
+		data += FormatUserRecord(user);
+		data += '\n';
+	}
+
+	// A uniquely named temp file renamed over users.txt in one step, so a
+	// crash at any point leaves either the old snapshot or the new one
+	return AtomicFile::replace("users.txt", { data });
+}
+
+void RecoverSnapshot()
+{
+	// temp.txt is left by older builds, which removed users.txt before
+	// renaming; it is only complete if the crash hit between the two
+	AtomicFile::recover("users.txt", "temp.txt");
+}
+
+void CompactLog()
+{
+	UserLog& log = GetUserLog();
+
+	if (log.compacting)
+		return;
+
+	if (log.compactor.joinable())
+		log.compactor.join();
+
+	// Rotate the live log so new entries never race the snapshot writer.
+	// If a previous compaction failed its log is still pending: retry
+	// without rotating so nothing is overwritten.
+	std::ifstream pending("users.log.compacting");
+
+	if (!pending)
+	{
+		log.out.close();
+		rename("users.log", "users.log.compacting");
+		log.out.clear();
+		log.out.open("users.log", std::ios::app);
+		log.entries = 0;
+		log.rotated = AtomicFile::stamp("users.log.compacting");
+
+		// Instances starting from here on replay the new log, not this one
+		PublishSharedIndex(GetUserIndex());
+	}
+
+	pending.close();
+
+	log.compacting = true;
+	log.compactor = std::thread([users = SnapshotUsers(), rotated = log.rotated]()
+	{
+		UserLog& log = GetUserLog();
+
+		{
+			// A lock of its own: the caller still holds log.lock
+			FileLock lock("users.lock");
+			std::lock_guard<FileLock> exclusive(lock);
+
+			// Another instance folded this log into a newer snapshot meanwhile
+			const AtomicFile::Stamp before = AtomicFile::stamp("users.txt");
+
+			if (AtomicFile::stamp("users.log.compacting") == rotated && WriteSnapshot(users))
+			{
+				remove("users.log.compacting");
+
+				// Same users, new file: keep the shared image attachable
+				SharedIndexImage image;
+				SharedIndexHeader* header = SharedHeader();
+
+				if (header && header->image.tryLoad(image) && image.snapshot == before)
+				{
+					image.snapshot = AtomicFile::stamp("users.txt");
+					header->image.store(image);
+				}
+
+				// Nothing new to load: spare this instance a reload
+				std::lock_guard<std::mutex> guard(log.stampMutex);
+				if (log.snapshotStamp == before)
+					log.snapshotStamp = AtomicFile::stamp("users.txt");
+			}
+		}
+
+		log.compacting = false;
+	});
+}
+
+// On taking users.lock: fold in whatever other instances changed since
+// this one last held it
+static void CatchUpUserFiles()
+{
+	UserLog& log = GetUserLog();
+
+	AtomicFile::Stamp snapshot = AtomicFile::stamp("users.txt");
+	AtomicFile::Stamp changes = AtomicFile::stamp("users.log");
+
+	std::unique_lock<std::mutex> guard(log.stampMutex);
+	const AtomicFile::Stamp knownSnapshot = log.snapshotStamp;
+	const AtomicFile::Stamp knownLog = log.logStamp;
+	guard.unlock();
+
+	if (snapshot == knownSnapshot && changes == knownLog)
+		return;
+
+	// Other instances only appended: replay just their entries
+	if (snapshot == knownSnapshot && changes.exists && knownLog.exists
+		&& changes.identity == knownLog.identity && changes.size > knownLog.size)
+	{
+		log.entries += ReplayLog("users.log", knownLog.size);
+		return;
+	}
+
+	// A new snapshot or a rotated log: start over from the files
+	UserIndex& index = GetUserIndex();
+	index = UserIndex();
+	LoadUserIndex(index);
+}
+
+void LockUserFiles()
+{
+	UserLog& log = GetUserLog();
+
+	if (log.lockDepth++ > 0)
+		return;
+
+	if (!log.lock.isOpen())
+		log.lock.open("users.lock");
+
+	log.lock.lock();
+
+	OpenSharedIndex();
+
+	if (log.synced)
+		CatchUpUserFiles();
+
+	if (log.sharedHeader.isOpen())
+		log.seenChanges = SharedHeader()->changes.load();
+}
+
+// The index is current unless another instance has written since this
+// one last held users.lock; the shared change counter tells without
+// taking the lock. Returns whether it had to lock.
+bool LockUserFilesForRead()
+{
+	UserLog& log = GetUserLog();
+	const SharedIndexHeader* header = SharedHeader();
+
+	if (log.lockDepth > 0 || (log.synced && header
+		&& header->changes.load(std::memory_order_acquire) == log.seenChanges))
+		return false;
+
+	LockUserFiles();
+	return true;
+}
+
+void UnlockUserFiles()
+{
+	UserLog& log = GetUserLog();
+
+	if (log.lockDepth == 1 && log.synced && log.entries >= LOG_COMPACT_THRESHOLD)
+		CompactLog();
+
+	if (--log.lockDepth > 0)
+		return;
+
+	log.out.flush();
+
+	if (log.synced)
+	{
+		std::lock_guard<std::mutex> guard(log.stampMutex);
+		log.snapshotStamp = AtomicFile::stamp("users.txt");
+		log.logStamp = AtomicFile::stamp("users.log");
+	}
+
+	// Tell readers in other instances to catch up
+	if (log.changed && log.sharedHeader.isOpen())
+	{
+		log.seenChanges = SharedHeader()->changes.fetch_add(1, std::memory_order_acq_rel) + 1;
+	}
+
+	log.changed = false;
+	log.lock.unlock();
+}
+
+/*
+* ==================== Bulk Import / Export ====================
+*/
+
+const size_t IMPORT_MIN_CHUNK = 1 << 20;   // bytes of CSV per parser thread
+
+// Parse and validate every line of data[begin, end) into users
+static void ParseImportChunk(const std::string& data, size_t begin, size_t end,
+	std::vector<User>& users, size_t& invalid)
+{
+	const std::string_view text(data);
+	User user;
+
+	while (begin < end)
+	{
+		size_t newline = text.find('\n', begin);
+		if (newline == std::string_view::npos || newline > end)
+			newline = end;
+
+		std::string_view line = text.substr(begin, newline - begin);
+		begin = newline + 1;
+
+		if (line.empty() || line == "\r")
+			continue;
+
+		if (!ParseUserRecord(line, user)
+			|| !IsValidEmail(user.email)
+			|| !IsValidUsername(user.username)
+			|| !IsValidPassword(user.password))
+		{
+			++invalid;
+			continue;
+		}
+
+		users.push_back(user);
+	}
+}
+
+bool ImportUsers(const std::string& path, ImportReport& report)
+{
+	std::ifstream file(path, std::ios::binary);
+
+	if (!file)
+		return false;
+
+	std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	file.close();
+
+	// Split on line boundaries and parse the chunks in parallel; nothing
+	// here touches the index, so the threads share no state
+	size_t threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+	threads = std::min(threads, data.size() / IMPORT_MIN_CHUNK + 1);
+
+	std::vector<size_t> bounds(1, 0);
+	for (size_t i = 1; i < threads; ++i)
+	{
+		size_t cut = data.find('\n', std::max(bounds.back(), data.size() * i / threads));
+		if (cut == std::string::npos)
+			break;
+
+		bounds.push_back(cut + 1);
+	}
+	bounds.push_back(data.size());
+
+	size_t chunks = bounds.size() - 1;
+	std::vector<std::vector<User>> parsed(chunks);
+	std::vector<size_t> invalid(chunks, 0);
+	std::vector<std::thread> workers;
+
+	for (size_t i = 1; i < chunks; ++i)
+	{
+		workers.emplace_back(ParseImportChunk, std::cref(data), bounds[i], bounds[i + 1],
+			std::ref(parsed[i]), std::ref(invalid[i]));
+	}
+
+	ParseImportChunk(data, bounds[0], bounds[1], parsed[0], invalid[0]);
+
+	for (std::thread& worker : workers)
+		worker.join();
+
+	// Dedup and assign ids in file order. A compaction in flight is
+	// superseded by the snapshot written below, so let it finish first.
+	UserIndex& index = GetUserIndex();
+	UserLog& log = GetUserLog();
+
+	if (log.compactor.joinable())
+		log.compactor.join();
+
+	LockUserFiles();
+
+	size_t rows = 0;
+	for (const std::vector<User>& chunk : parsed)
+		rows += chunk.size();
+
+	ReserveUserIndex(index.records.size() + rows);
+
+	const int64_t now = Timestamp::now();
+	const int firstId = index.maxId + 1;
+	int nextId = firstId;
+
+	report = ImportReport();
+
+	for (size_t i = 0; i < chunks; ++i)
+	{
+		report.invalid += invalid[i];
+
+		for (User& user : parsed[i])
+		{
+			if (EmailExists(user.email) || UsernameExists(user.username))
+			{
+				++report.duplicates;
+				continue;
+			}
+
+			user.id = nextId++;
+			if (user.createdAt == 0)
+				user.createdAt = now;
+			if (user.lastLogin == 0)
+				user.lastLogin = user.createdAt;
+
+			IndexUser(user);
+			++report.imported;
+		}
+	}
+
+	if (report.imported == 0)
+	{
+		UnlockUserFiles();
+		return true;
+	}
+
+	// One sequential snapshot instead of a log entry per row. It already
+	// includes every logged change, so the logs start over.
+	if (!WriteSnapshot(SnapshotUsers()))
+	{
+		for (int id = firstId; id < nextId; ++id)
+			UnindexUser(id);
+
+		index.maxId = firstId - 1;
+		report.imported = 0;
+		UnlockUserFiles();
+		return false;
+	}
+
+	log.out.close();
+	remove("users.log.compacting");
+	std::ofstream truncate("users.log", std::ios::trunc);
+	truncate.close();
+	log.out.clear();
+	log.out.open("users.log", std::ios::app);
+	log.entries = 0;
+	log.changed = true;
+
+	PublishSharedIndex(index);
+
+	UnlockUserFiles();
+	return true;
+}
+
+bool ExportUsers(const std::string& path, size_t& exported)
+{
+	const UserIndex& index = GetUserIndex();
+
+	// Only record pointers are sorted; records stream straight from the index
+	std::vector<const UserRecord*> sorted;
+	sorted.reserve(index.records.size());
+
+	for (const UserRecord& record : index.records)
+		sorted.push_back(&record);
+
+	std::sort(sorted.begin(), sorted.end(),
+		[](const UserRecord* a, const UserRecord* b) { return a->id < b->id; });
+
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+
+	if (!out)
+		return false;
+
+	std::string buffer;
+	buffer.reserve(1 << 16);
+	exported = 0;
+
+	User user;
+
+	for (const UserRecord* record : sorted)
+	{
+		LoadRecord(index, *record, user);
+		buffer += FormatUserRecord(user);
+		buffer += '\n';
+
+		if (buffer.size() >= (1 << 16) - 512)
+		{
+			out.write(buffer.data(), buffer.size());
+			buffer.clear();
+		}
+
+		++exported;
+	}
+
+	out.write(buffer.data(), buffer.size());
+	out.close();
+
+	return static_cast<bool>(out);
+}
+
+/*
+* ==================== Main ====================
+* Benchmark builds define V1_NO_MAIN to link the functions above into
+* their own executable.
+*/
+
+#ifndef V1_NO_MAIN
+
+// Non-interactive bulk mode: --import <file> or --export <file>
+static int RunBulkCommand(const std::string& command, const std::string& path)
+{
+	if (command == "--import")
+	{
+		ImportReport report;
+
+		if (!ImportUsers(path, report))
+		{
+			std::cerr << "Import failed: " << path << std::endl;
+			return 1;
+		}
+
+		std::cout << "Imported " << report.imported << " users ("
+			<< report.invalid << " invalid, " << report.duplicates << " duplicates)" << std::endl;
+		return 0;
+	}
+
+	if (command == "--export")
+	{
+		size_t exported = 0;
+
+		if (!ExportUsers(path, exported))
+		{
+			std::cerr << "Export failed: " << path << std::endl;
+			return 1;
+		}
+
+		std::cout << "Exported " << exported << " users" << std::endl;
+		return 0;
+	}
+
+	std::cerr << "Usage: V1_Foundations_UserLoginSystem [--import <file> | --export <file>]" << std::endl;
+	return 2;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1)
+		return RunBulkCommand(argv[1], argc > 2 ? argv[2] : "");
+
+	while (true)
+	{
+		User user;
+		InitialScreen();
+		int choice = InitialChoice();
+
+		if (choice == 3)
+			break;
+
+		LoginOrRegister(user, choice);
+	}
+
+	std::cout << "\nThank you for using Blog System v1.0!" << std::endl;
+	std::cout << "Goodbye!" << std::endl;
+
+	return 0;
+}
+
+#endif // V1_NO_MAIN
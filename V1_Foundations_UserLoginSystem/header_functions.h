@@ -1,6 +1,17 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "../V2_Guardian_OOP Refactor/include/AtomicFile.h"  // Shared crash-safe file replace
+#include "../V2_Guardian_OOP Refactor/include/FileLock.h"    // Shared advisory file lock
+#include "../V2_Guardian_OOP Refactor/include/SeqLock.h"     // Shared lock-free reader protocol
+#include "../V2_Guardian_OOP Refactor/include/SharedMemory.h" // Shared named memory segments
 
 /*
 * ==================== User Structure ====================
@@ -12,8 +23,124 @@ struct User
 	std::string email;
 	std::string username;
 	std::string password;
-	std::string createdAt;    // NEW: Account creation timestamp
-	std::string lastLogin;    // NEW: Last login timestamp
+	int64_t createdAt = 0;    // NEW: Account creation timestamp (see Timestamp.h)
+	int64_t lastLogin = 0;    // NEW: Last login timestamp
+};
+
+/*
+* ==================== User Index ====================
+* Loaded once from users.txt, then kept in sync by CreateUser,
+* RewriteUser and DeleteUser so lookups never rescan the file.
+*
+* Records are fixed size and keep their strings back to back in one
+* shared pool. The id, email and username lookups are open-addressing
+* tables of record positions, so a cached user costs a few dozen bytes
+* instead of a map node plus five separately allocated strings.
+*/
+
+struct UserRecord
+{
+	int id;
+	uint32_t offset;                            // email, username, password in the pool
+	uint16_t emailLength;
+	uint16_t usernameLength;
+	uint16_t passwordLength;
+	int64_t createdAt;
+	int64_t lastLogin;
+};
+
+struct UserIndex
+{
+	std::vector<UserRecord> records;            // unordered; a delete moves the last one in
+	std::string pool;
+	size_t poolGarbage = 0;                     // pool bytes no record points at
+	std::vector<uint32_t> byId;                 // position + 1, 0 = empty slot
+	std::vector<uint32_t> byEmail;
+	std::vector<uint32_t> byUsername;
+	int maxId = 0;
+	bool loaded = false;
+};
+
+/*
+* ==================== Shared Index ====================
+* Instances on one host share the loaded index through shared memory.
+* Whoever holds users.lock publishes an immutable image of the index
+* into a fresh segment and points the header at it; a process started
+* later copies the image instead of parsing users.txt, then replays the
+* log past it. Reads skip users.lock while the header's change counter
+* says no other instance has written.
+*
+* Every attached instance holds users.instances shared. The one that
+* exits and finds no other holder unlinks the header and the newest
+* image; an instance that crashed loses its hold all the same.
+*/
+
+struct SharedIndexImage
+{
+	uint64_t generation = 0;                    // names the image segment, 0 = none yet
+	AtomicFile::Stamp snapshot;                 // users.txt the image was built from
+	AtomicFile::Stamp log;                      // users.log, applied up to log.size
+	uint64_t records = 0;
+	uint64_t slots = 0;                         // per lookup table
+	uint64_t poolSize = 0;
+	uint64_t poolGarbage = 0;
+	int maxId = 0;
+};
+
+struct SharedIndexHeader
+{
+	char magic[8];
+	uint32_t version;
+	std::atomic<uint64_t> changes{ 0 };         // bumped by every instance that writes
+	SeqLock<SharedIndexImage> image;
+};
+
+/*
+* ==================== Write-Ahead Log ====================
+* users.txt is a snapshot; every change since it was written is appended
+* to users.log as one checksummed line. Compaction folds the log back
+* into the snapshot on a background thread.
+*
+* Several instances may share one directory. Every read-modify-write
+* holds users.lock (LockUserFiles); on taking it an instance catches up
+* with whatever the others changed since it last held the lock.
+*/
+
+struct UserLog
+{
+	std::ofstream out;                          // users.log, append mode
+	size_t entries = 0;                         // entries since last compaction
+	std::thread compactor;
+	std::atomic<bool> compacting{ false };
+	AtomicFile::Stamp rotated;                  // users.log.compacting as rotated
+
+	FileLock lock;                              // users.lock
+	int lockDepth = 0;                          // LockUserFiles nests
+	bool synced = false;                        // stamps below match the index
+	std::mutex stampMutex;                      // the compactor updates snapshotStamp
+	AtomicFile::Stamp snapshotStamp;            // users.txt as of the last unlock
+	AtomicFile::Stamp logStamp;                 // users.log as of the last unlock
+	bool changed = false;                       // wrote users under the current lock
+
+	std::string sharedName;                     // empty until the first lock
+	SharedMemory sharedHeader;                  // SharedIndexHeader for this directory
+	SharedMemory sharedImage;                   // the last image this instance published
+	FileLock instances;                         // users.instances, held shared while attached
+	uint64_t seenChanges = 0;                   // header changes the index includes
+
+	~UserLog();
+};
+
+/*
+* ==================== Bulk Import ====================
+* Outcome of ImportUsers: every input row is counted exactly once.
+*/
+
+struct ImportReport
+{
+	size_t imported = 0;
+	size_t invalid = 0;                         // malformed or failed validation
+	size_t duplicates = 0;                      // email or username already taken
 };
 
 /*
@@ -69,7 +196,7 @@ bool UsernameExists(const std::string& username);         // NEW
 int GetLastId();
 void UpdateUser(User& updatedUser);
 void ChangePassword(User& user);                          // NEW
-void RewriteUser(const User& updatedUser, const std::string& oldEmail);
+void RewriteUser(const User& updatedUser);
 void DeleteUser(const User& deletedUser);
 
 /*
@@ -78,3 +205,51 @@ void DeleteUser(const User& deletedUser);
 
 std::string GetCurrentDateTime();                         // NEW
 void UpdateLastLogin(User& user);                         // NEW
+
+/*
+* ==================== Index Operations ====================
+*/
+
+UserIndex& GetUserIndex();
+void LoadUserIndex(UserIndex& index);
+void IndexUser(const User& user);
+void UnindexUser(int id);
+bool FindUserByUsername(const std::string& username, User& user);
+bool IndexHasEmail(std::string_view email);
+bool IndexHasUsername(std::string_view username);
+void ReserveUserIndex(size_t records);
+
+/*
+* ==================== Log Operations ====================
+*/
+
+UserLog& GetUserLog();
+std::string FormatUserRecord(const User& user);
+bool ParseUserRecord(std::string_view line, User& user);
+unsigned int Checksum(std::string_view data);
+bool AppendLogEntry(const std::string& payload);
+size_t ReplayLog(const std::string& path, uint64_t offset = 0);
+bool WriteSnapshot(const std::vector<User>& users);
+std::vector<User> SnapshotUsers();
+void RecoverSnapshot();
+void CompactLog();
+void LockUserFiles();
+bool LockUserFilesForRead();                              // false if already current
+void UnlockUserFiles();
+
+/*
+* ==================== Shared Index Operations ====================
+* Call with users.lock held.
+*/
+
+bool AttachSharedIndex(UserIndex& index, uint64_t& logOffset);
+void PublishSharedIndex(const UserIndex& index);
+
+/*
+* ==================== Bulk Import / Export ====================
+* For onboarding large CSV files in the users.txt format without going
+* through CreateUser row by row.
+*/
+
+bool ImportUsers(const std::string& path, ImportReport& report);
+bool ExportUsers(const std::string& path, size_t& exported);
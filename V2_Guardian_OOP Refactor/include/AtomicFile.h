@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+// Crash-consistent whole-file replacement.
+//
+// replace() writes a temp file with a unique name beside the target,
+// syncs it, renames it over the target in one step and syncs the
+// directory. The target is never removed first, so after a crash a
+// reader finds either the old file or the new one, and two writers never
+// share a temp file. Callers serialize writers to one target themselves,
+// e.g. with a FileLock.
+class AtomicFile {
+public:
+    // Enough to notice another process replacing or appending to a file
+    struct Stamp {
+        bool exists = false;
+        uint64_t identity = 0; // inode; 0 where the platform has none
+        uint64_t size = 0;
+        int64_t modified = 0;
+
+        bool operator==(const Stamp& other) const {
+            return exists == other.exists && identity == other.identity
+                && size == other.size && modified == other.modified;
+        }
+        bool operator!=(const Stamp& other) const { return !(*this == other); }
+    };
+
+public:
+    static bool replace(const std::string& path, std::initializer_list<std::string_view> parts);
+
+    // Flushes the data of a file changed in place, e.g. through a stream
+    static bool sync(const std::string& path);
+
+    // Startup scan, run with writers locked out. Temp files left by a
+    // crashed replace() are discarded: the rename never happened, so the
+    // target is still whole. legacyTempPath names a fixed temp file from
+    // the older remove-then-rename scheme; it is finished if the target is
+    // missing (the crash fell between the two) and discarded otherwise.
+    // Returns how many files were finished or discarded.
+    static size_t recover(const std::string& path, const std::string& legacyTempPath = "");
+
+    static Stamp stamp(const std::string& path);
+
+private:
+    static std::string tempPath(const std::string& path);
+    static bool writeDurably(const std::string& path, std::initializer_list<std::string_view> parts);
+    static bool renameOver(const std::string& from, const std::string& to);
+    static bool syncDirectory(const std::string& path);
+
+    AtomicFile() = delete;
+};
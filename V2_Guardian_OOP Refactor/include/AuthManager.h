@@ -1,5 +1,8 @@
 #pragma once
 #include <string>
+#include "LoginThrottle.h"
+#include "PasswordHasher.h"
+#include "SessionStore.h"
 #include "User.h"
 #include "UserRepository.h"
 
@@ -7,12 +10,19 @@ class AuthManager {
 private:
     UserRepository& repository;
     User* currentUser;
+    PasswordHasher hasher;
+    SessionStore sessions;
+    LoginThrottle throttle; // checked before any lookup or hash work
 
 public:
     // Constructor / Destructor
-    explicit AuthManager(UserRepository& repo);
+    explicit AuthManager(UserRepository& repo, const PasswordHasher& hasher = PasswordHasher(),
+        LoginThrottleOptions throttleOptions = LoginThrottleOptions());
     ~AuthManager();
 
+    AuthManager(const AuthManager&) = delete;
+    AuthManager& operator=(const AuthManager&) = delete;
+
     // Main operations (interactive - get input from user)
     bool registerUser();
     bool login();
@@ -22,15 +32,29 @@ public:
     bool registerUser(const std::string& username,
         const std::string& password,
         const std::string& email);
-    bool login(const std::string& username, const std::string& password);
+    // source identifies the client (e.g. its address) for throttling;
+    // empty for the local console
+    bool login(const std::string& username, const std::string& password,
+        const std::string& source = "");
 
     // Session queries
     bool isLoggedIn() const { return currentUser != nullptr; }
     User* getCurrentUser() const { return currentUser; }
     std::string getCurrentUsername() const {
-        return currentUser ? currentUser->getUsername() : "";
+        return currentUser ? std::string(currentUser->getUsername()) : "";
     }
 
+    // Token sessions for server use: any number of users can be signed in
+    // at once, independently of the interactive currentUser
+    bool openSession(const std::string& username, const std::string& password,
+        SessionStore::Token& token, const std::string& source = "");
+    int sessionUserId(const SessionStore::Token& token);  // 0 if invalid or expired
+    bool closeSession(const SessionStore::Token& token);
+    size_t expireSessions() { return sessions.expire(); }
+
+    // Brute-force throttling counters
+    LoginThrottle::Metrics throttleMetrics() const { return throttle.metrics(); }
+
     // Display current user info
     void displayCurrentUserInfo() const;
 
@@ -40,6 +64,14 @@ private:
     std::string promptEmail();
     std::string promptPassword();
 
+    // Verify credentials unless throttled; caller owns the returned user
+    // (nullptr on failure)
+    User* authenticate(const std::string& username, const std::string& password,
+        const std::string& source);
+
+    // Upgrade a legacy plaintext or outdated hash after a successful login
+    void rehashIfNeeded(User& user, const std::string& password);
+
     // Validation (uses Validator class)
     bool validateRegistrationInput(const std::string& username,
         const std::string& password,
@@ -0,0 +1,72 @@
+#pragma once
+#include "LoginThrottle.h"
+#include "PasswordHasher.h"
+#include "ThreadPool.h"
+#include "UserRepository.h"
+#include <future>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Non-interactive authentication for bulk or concurrent callers.
+//
+// Username -> (id, stored hash) is held in memory and shared by all
+// workers under a reader-writer lock: lookups take it shared, reloads
+// and rehashes take it exclusive. The expensive Argon2id verification
+// runs on a work-stealing pool outside the lock, so throughput scales
+// with cores. Every check goes through a LoginThrottle first, as
+// AuthManager's logins do, so a batch cannot be used to guess passwords
+// faster than the interactive path allows.
+class AuthService {
+public:
+    struct Credentials {
+        std::string username;
+        std::string password;
+        std::string source; // empty for a local caller, not limited by source
+    };
+
+    struct Result {
+        bool authenticated = false;
+        int userId = 0;
+        bool throttled = false; // refused before the password was checked
+    };
+
+public:
+    explicit AuthService(UserRepository& repo,
+        size_t threadCount = std::thread::hardware_concurrency(),
+        const PasswordHasher& hasher = PasswordHasher(),
+        LoginThrottleOptions throttleOptions = LoginThrottleOptions());
+
+    AuthService(const AuthService&) = delete;
+    AuthService& operator=(const AuthService&) = delete;
+
+    // Asynchronous checks - each future resolves once its hash is verified
+    std::future<Result> verify(Credentials credentials);
+    std::vector<std::future<Result>> verifyBatch(const std::vector<Credentials>& batch);
+
+    // Synchronous check on the calling thread
+    Result verifyNow(const Credentials& credentials);
+
+    // Reload the in-memory index from the repository
+    void refresh();
+
+    LoginThrottle::Metrics throttleMetrics() const { return throttle.metrics(); }
+
+private:
+    struct Entry {
+        int id;
+        std::string storedHash;
+    };
+
+    void rehash(const std::string& username, int id, const std::string& password);
+
+    UserRepository& repository;
+    PasswordHasher hasher;
+    LoginThrottle throttle; // checked before any lookup or hash work
+
+    std::unordered_map<std::string, Entry> index;
+    mutable std::shared_mutex indexMutex;
+
+    ThreadPool pool; // last: workers must stop before the index goes away
+};
@@ -0,0 +1,121 @@
+#pragma once
+#include "AtomicFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Disk-resident B+-tree mapping a string key to an int32 value (a user id).
+//
+// The index lives in its own page file: page 0 holds the metadata, every
+// other page is a leaf or an internal node. Only the pages on the path to a
+// key are read, so point lookups cost O(log n) page reads and prefix scans
+// walk the linked leaves in key order.
+//
+// Erasing never merges pages; underfull leaves are tolerated and a
+// rebuild() compacts the tree again.
+//
+// Pages are updated in place and only flushed. The metadata records the
+// data file the keys describe, and setSource() syncs the pages before
+// recording a new one, so a tree a crash left half updated never claims
+// to match the data file on disk and its owner rebuilds it.
+class BPlusTreeIndex {
+public:
+    static constexpr size_t PAGE_SIZE = 4096;
+    static constexpr size_t MAX_KEY_LENGTH = 120;
+
+public:
+    BPlusTreeIndex() = default;
+
+    BPlusTreeIndex(const BPlusTreeIndex&) = delete;
+    BPlusTreeIndex& operator=(const BPlusTreeIndex&) = delete;
+
+    // File management - open() creates an empty tree if the file is missing
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return file.is_open(); }
+
+    // Point operations - keys longer than MAX_KEY_LENGTH are refused
+    bool insert(std::string_view key, int32_t value); // inserts or overwrites
+    bool erase(std::string_view key);
+    bool find(std::string_view key, int32_t& value) const;
+
+    // Ordered scan of every key starting with prefix
+    std::vector<int32_t> prefixScan(std::string_view prefix, size_t limit = SIZE_MAX) const;
+
+    // Replace the whole tree with a bulk-loaded one built from source;
+    // fails, changing nothing, if any key is too long
+    bool rebuild(std::vector<std::pair<std::string, int32_t>> entries,
+        const AtomicFile::Stamp& source = AtomicFile::Stamp());
+
+    // What the tree describes - set, synced, once the data file it covers is saved
+    bool builtFrom(const AtomicFile::Stamp& source) const;
+    bool setSource(const AtomicFile::Stamp& source);
+
+    size_t size() const { return meta.keyCount; }
+
+private:
+    struct Meta {
+        char magic[4];
+        uint32_t version;
+        uint32_t rootPage;
+        uint32_t pageCount;
+        uint64_t keyCount;
+        uint64_t sourceIdentity;
+        uint64_t sourceSize;
+        int64_t sourceModified;
+    };
+
+    struct PageHeader {
+        uint8_t isLeaf;
+        uint8_t reserved;
+        uint16_t count;
+        uint32_t nextLeaf;   // leaves: right sibling, 0 if none
+        uint32_t firstChild; // internal: child holding keys below entries[0]
+        uint32_t padding;
+    };
+
+    struct Entry {
+        char key[MAX_KEY_LENGTH];
+        uint32_t keyLength;
+        int32_t value;       // leaves: user id, internal: child page
+    };
+
+    static constexpr size_t CAPACITY = (PAGE_SIZE - sizeof(PageHeader)) / sizeof(Entry);
+
+    struct Page {
+        PageHeader header;
+        Entry entries[CAPACITY];
+        char padding[PAGE_SIZE - sizeof(PageHeader) - CAPACITY * sizeof(Entry)];
+    };
+
+    static_assert(sizeof(Page) == PAGE_SIZE, "Page must fill exactly one disk page");
+
+    struct Split {
+        bool happened = false;
+        Entry separator{};   // key + new right page
+    };
+
+    // Page I/O
+    bool readPage(uint32_t pageId, Page& page) const;
+    bool writePage(uint32_t pageId, const Page& page);
+    bool writeMeta();
+    bool sync();
+    uint32_t allocatePage();
+
+    // Tree helpers
+    static std::string_view keyOf(const Entry& entry);
+    static Entry makeEntry(std::string_view key, int32_t value);
+    static size_t lowerBound(const Page& page, std::string_view key);
+    static size_t childSlot(const Page& page, std::string_view key);
+    static uint32_t childAt(const Page& page, size_t slot);
+    bool findLeaf(std::string_view key, uint32_t& pageId, Page& page) const;
+    bool insertInto(uint32_t pageId, const Entry& entry, Split& split, bool& added);
+
+    std::string path;
+    mutable std::fstream file;
+    Meta meta{};
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include "AtomicFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Blocked Bloom filter over string keys, kept in memory and persisted to
+// its own file. A "no" is definite, so a lookup for a key that was never
+// added can skip storage entirely; a "maybe" falls through to the index.
+//
+// Every key maps to one 64-byte block (one cache line) and sets one bit
+// in each of its eight words, so a probe touches a single line. Keys can
+// be added but not removed: a removed key just reads as "maybe" until
+// the next rebuild, and full() says when that is due.
+//
+// File layout: a 64-byte header, then the blocks. open() reads the file
+// and lets go of it; add() only dirties the blocks it touches and flush()
+// writes back just those, synced. The header records the data file the
+// keys came from, so its owner can tell a filter left over from another
+// one - which would answer "no" for keys that file holds - and rebuild.
+class BloomFilter {
+public:
+    static constexpr size_t BLOCK_SIZE = 64;
+    static constexpr size_t BITS_PER_KEY = 12; // under 1% false positives at capacity
+
+    // The data file the keys were taken from
+    struct Source {
+        uint64_t records = 0;
+        AtomicFile::Stamp data;
+    };
+
+public:
+    BloomFilter() = default;
+
+    BloomFilter(const BloomFilter&) = delete;
+    BloomFilter& operator=(const BloomFilter&) = delete;
+
+    // File management - open() fails on a missing or damaged file, and a
+    // closed filter answers "maybe" to everything
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return !blocks.empty(); }
+
+    // Probing and incremental updates
+    bool mayContain(std::string_view key) const;
+    void add(std::string_view key);
+    bool flush();
+
+    // What the filter describes - set once the data file it covers is saved
+    bool builtFrom(const Source& source) const;
+    bool setSource(const Source& source);
+
+    // Replace the whole filter, sized for capacity keys
+    bool rebuild(const std::string& path, const std::vector<std::string_view>& keys, size_t capacity,
+        const Source& source);
+
+    size_t size() const { return static_cast<size_t>(header.keyCount); } // keys added, removed ones included
+    bool full() const { return header.keyCount > header.capacity; }
+
+private:
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint64_t blockCount;
+        uint64_t keyCount;
+        uint64_t capacity;
+        uint64_t sourceRecords;
+        uint64_t sourceIdentity;
+        uint64_t sourceSize;
+        int64_t sourceModified;
+    };
+
+    struct alignas(BLOCK_SIZE) Block {
+        uint64_t words[BLOCK_SIZE / sizeof(uint64_t)];
+    };
+
+    static_assert(sizeof(Header) == BLOCK_SIZE, "Header must fill exactly one block");
+    static_assert(sizeof(Block) == BLOCK_SIZE, "Block must fill exactly one cache line");
+
+    static uint64_t hash(std::string_view key);
+    static Block maskFor(uint64_t hash);
+    size_t blockFor(uint64_t hash) const;
+    bool writeBack();
+
+    std::string path;
+    Header header{};
+    std::vector<Block> blocks;
+    std::vector<size_t> dirty; // blocks changed since the last flush()
+};
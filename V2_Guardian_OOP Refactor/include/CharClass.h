@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Byte classification kernels behind the validators.
+//
+// Every byte falls into exactly one class. Classification is plain ASCII,
+// which is what <cctype> answers in the default "C" locale, minus the
+// per-call locale lookup. Bytes >= 0x80 are OTHER.
+//
+// Three kernels implement the same two primitives:
+//   AVX2    32 bytes per step, range compares
+//   SSE4.2  16 bytes per step, PCMPESTRI range matching
+//   SCALAR  table lookup, always available
+// The best one the CPU supports is selected on first use.
+class CharClass {
+public:
+    enum Class : uint8_t {
+        UPPER      = 1 << 0, // A-Z
+        LOWER      = 1 << 1, // a-z
+        DIGIT      = 1 << 2, // 0-9
+        UNDERSCORE = 1 << 3, // _
+        DOT_DASH   = 1 << 4, // . -
+        SPACE      = 1 << 5, // ' ' \t \n \v \f \r
+        OTHER      = 1 << 6  // everything else
+    };
+
+    static constexpr uint8_t ALPHA = UPPER | LOWER;
+    static constexpr uint8_t ALNUM = ALPHA | DIGIT;
+
+    enum Kernel { SCALAR, SSE42, AVX2 };
+
+public:
+    static uint8_t classOf(char c) { return TABLE[static_cast<unsigned char>(c)]; }
+
+    // Index of the first byte whose class is not in classes, or length if
+    // there is none. classes must not include OTHER
+    static size_t findFirstNotIn(const char* data, size_t length, uint8_t classes);
+
+    // Union of the classes of all bytes
+    static uint8_t classesPresent(const char* data, size_t length);
+
+    // Kernel selection. setKernel is for differential testing and
+    // benchmarks; it falls back to the best supported kernel
+    static Kernel activeKernel();
+    static Kernel bestSupportedKernel();
+    static void setKernel(Kernel kernel);
+
+private:
+    CharClass() = delete;
+
+    static const uint8_t TABLE[256];
+};
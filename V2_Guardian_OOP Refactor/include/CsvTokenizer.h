@@ -0,0 +1,45 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Splits one CSV record into std::string_view fields without allocating.
+//
+// Quoting follows RFC 4180: a field that contains a comma or a quote is
+// wrapped in double quotes, and embedded quotes are doubled. Records are a
+// single line, so quoted fields cannot contain line breaks.
+//
+// Plain fields are views into the caller's line, located with memchr.
+// Quoted fields are unescaped into an internal buffer that is reused
+// across calls. The views stay valid until the next tokenize() or until
+// the caller's line changes.
+class CsvTokenizer {
+public:
+    static constexpr size_t MAX_FIELDS = 16;
+
+public:
+    // False on more than MAX_FIELDS fields. A line that is not valid quoted
+    // CSV - an unterminated quote, text after a closing one - is split on
+    // every comma instead, as records written before quoting were.
+    bool tokenize(std::string_view line);
+
+    size_t size() const { return count; }
+    std::string_view operator[](size_t index) const { return fields[index]; }
+
+    // Field at index, or empty if the record is shorter
+    std::string_view field(size_t index) const {
+        return index < count ? fields[index] : std::string_view();
+    }
+
+    // Append field to out, quoting it only if needed
+    static void appendField(std::string& out, std::string_view field);
+
+private:
+    bool split(std::string_view line, bool quoting);
+    bool tokenizeQuoted(std::string_view line, size_t& pos);
+
+    std::array<std::string_view, MAX_FIELDS> fields;
+    size_t count = 0;
+    std::string unescaped; // backing store for quoted fields
+};
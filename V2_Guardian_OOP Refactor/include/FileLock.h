@@ -0,0 +1,43 @@
+#pragma once
+#include <string>
+
+// Advisory lock on a file, shared between processes (flock on POSIX,
+// LockFileEx on Windows). Cooperating instances lock the same path before
+// touching a data directory; nothing stops a process that does not ask.
+//
+// Meets the Lockable and SharedLockable requirements, so std::lock_guard
+// and std::shared_lock work. A lock belongs to this object's descriptor:
+// two FileLock objects exclude each other even within one process, but
+// threads sharing one object must serialize among themselves.
+class FileLock {
+public:
+    FileLock() = default;
+    explicit FileLock(const std::string& path);
+    ~FileLock();
+
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+    bool open(const std::string& path); // creates the file if missing
+    void close();
+    bool isOpen() const;
+
+    // Blocking; without an open file these do nothing
+    void lock();
+    void unlock();
+    void lock_shared();
+    void unlock_shared();
+
+    // Exclusive without waiting; false while anyone else holds the file
+    bool try_lock();
+
+private:
+    bool acquire(bool exclusive, bool wait);
+    void release();
+
+#ifdef _WIN32
+    void* handle = nullptr;
+#else
+    int fd = -1;
+#endif
+};
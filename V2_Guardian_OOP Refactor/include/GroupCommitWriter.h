@@ -0,0 +1,166 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct GroupCommitOptions {
+    // How long the writer waits for more requests after the first one of
+    // a batch arrives. Zero commits whatever is queued straight away,
+    // which still batches under load: requests pile up during each sync.
+    std::chrono::microseconds batchWindow{ 0 };
+    size_t maxBatchSize = 256;
+};
+
+// Group commit: callers on any thread submit requests and block, while a
+// single writer thread drains the queue in batches. Each batch is handed
+// to the commit function, which applies it and makes it durable with one
+// write and one sync, so N concurrent callers pay for one sync instead of
+// N. A caller is released once its batch is durable.
+template <typename Request>
+class GroupCommitWriter {
+public:
+    // Applies batch in order and syncs it; accepted[i] reports batch[i]
+    using Commit = std::function<void(std::vector<Request>& batch, std::vector<char>& accepted)>;
+
+public:
+    explicit GroupCommitWriter(Commit commit, GroupCommitOptions options = GroupCommitOptions());
+    ~GroupCommitWriter(); // commits anything still queued
+
+    GroupCommitWriter(const GroupCommitWriter&) = delete;
+    GroupCommitWriter& operator=(const GroupCommitWriter&) = delete;
+
+    // Blocks until the request's batch has been committed
+    bool submit(Request request);
+
+    size_t batchesCommitted() const;
+    size_t requestsCommitted() const;
+
+private:
+    struct Pending {
+        Request request;
+        bool accepted = false;
+        bool done = false;
+    };
+
+    void writerLoop();
+
+    Commit commit;
+    GroupCommitOptions options;
+
+    std::deque<Pending*> queue; // owned by the blocked callers
+    mutable std::mutex mutex;
+    std::condition_variable wake;      // writer: work arrived or stopping
+    std::condition_variable committed; // callers: a batch finished
+
+    size_t batches = 0;
+    size_t requests = 0;
+    bool stopping = false;
+
+    std::thread writer; // last: starts once everything above exists
+};
+
+// ==================== Constructor / Destructor ====================
+
+template <typename Request>
+GroupCommitWriter<Request>::GroupCommitWriter(Commit commit, GroupCommitOptions options)
+    : commit(std::move(commit)), options(options),
+      writer(&GroupCommitWriter::writerLoop, this) {}
+
+template <typename Request>
+GroupCommitWriter<Request>::~GroupCommitWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+}
+
+// ==================== Submission ====================
+
+template <typename Request>
+bool GroupCommitWriter<Request>::submit(Request request)
+{
+    Pending pending{ std::move(request) };
+
+    std::unique_lock<std::mutex> lock(mutex);
+    queue.push_back(&pending);
+    wake.notify_one();
+
+    committed.wait(lock, [&] { return pending.done; });
+    return pending.accepted;
+}
+
+template <typename Request>
+size_t GroupCommitWriter<Request>::batchesCommitted() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return batches;
+}
+
+template <typename Request>
+size_t GroupCommitWriter<Request>::requestsCommitted() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return requests;
+}
+
+// ==================== Writer ====================
+
+template <typename Request>
+void GroupCommitWriter<Request>::writerLoop()
+{
+    std::vector<Pending*> taken;
+    std::vector<Request> batch;
+    std::vector<char> accepted;
+    const size_t maxBatchSize = std::max<size_t>(1, options.maxBatchSize);
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    for (;;) {
+        wake.wait(lock, [&] { return stopping || !queue.empty(); });
+        if (queue.empty())
+            return; // stopping with nothing left to commit
+
+        // Give concurrent callers a chance to join this batch
+        if (!stopping && queue.size() < maxBatchSize && options.batchWindow.count() > 0) {
+            wake.wait_for(lock, options.batchWindow,
+                [&] { return stopping || queue.size() >= maxBatchSize; });
+        }
+
+        while (!queue.empty() && taken.size() < maxBatchSize) {
+            taken.push_back(queue.front());
+            queue.pop_front();
+        }
+
+        lock.unlock();
+
+        for (Pending* pending : taken)
+            batch.push_back(std::move(pending->request));
+        accepted.assign(batch.size(), 0);
+
+        commit(batch, accepted);
+
+        lock.lock();
+
+        for (size_t i = 0; i < taken.size(); ++i) {
+            taken[i]->accepted = accepted[i] != 0;
+            taken[i]->done = true;
+        }
+
+        ++batches;
+        requests += taken.size();
+
+        taken.clear();
+        batch.clear();
+        committed.notify_all();
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+struct LoginThrottleOptions {
+    // Failed logins allowed at once, and how fast that allowance comes back
+    double usernameBurst = 5;
+    double usernameRatePerSecond = 1.0 / 60;
+    double sourceBurst = 100;
+    double sourceRatePerSecond = 1;
+};
+
+// Brute-force throttling for logins, per username and per source.
+//
+// Each kind of key has a fixed-size count-min table of token buckets:
+// ROWS rows of COLUMNS cells, a key hashing to one cell per row. A key is
+// throttled only when every one of its cells is out of tokens, so a
+// collision can make a key stricter, never looser. A cell is one atomic
+// word holding how many tokens its bucket is short and when that was
+// last brought up to date, so checking is a few loads and charging a CAS
+// per row: no locks and no allocation, however many keys are seen.
+//
+// Only failures are charged. admit() runs before any storage or hashing
+// work and costs nanoseconds; a rejected login never reaches the disk.
+class LoginThrottle {
+public:
+    enum class Verdict { ALLOW, REJECT_USERNAME, REJECT_SOURCE };
+
+    struct Metrics {
+        uint64_t admitted = 0;
+        uint64_t rejectedUsername = 0;
+        uint64_t rejectedSource = 0;
+        uint64_t failures = 0;
+    };
+
+    static constexpr size_t ROWS = 4;
+    static constexpr size_t COLUMNS = 4096; // power of two
+    static constexpr size_t COUNTER_STRIPES = 16;
+
+public:
+    explicit LoginThrottle(LoginThrottleOptions options = LoginThrottleOptions());
+
+    LoginThrottle(const LoginThrottle&) = delete;
+    LoginThrottle& operator=(const LoginThrottle&) = delete;
+
+    // An empty source (a local console) is not limited by source
+    Verdict admit(std::string_view username, std::string_view source);
+    bool throttled(std::string_view username, std::string_view source) const; // admit() without counting
+    void recordFailure(std::string_view username, std::string_view source);
+
+    Metrics metrics() const;
+
+private:
+    struct Table {
+        std::array<std::array<std::atomic<uint64_t>, COLUMNS>, ROWS> cells{};
+        uint32_t burst = 0;  // tokens, fixed point
+        uint32_t refill = 0; // per tick, fixed point
+    };
+
+    struct Slots {
+        size_t column[ROWS];
+    };
+
+    // One cache line per stripe, so concurrent logins do not contend on
+    // the metrics
+    struct alignas(64) Counters {
+        std::atomic<uint64_t> admitted{ 0 };
+        std::atomic<uint64_t> rejectedUsername{ 0 };
+        std::atomic<uint64_t> rejectedSource{ 0 };
+        std::atomic<uint64_t> failures{ 0 };
+    };
+
+    Slots slotsFor(std::string_view key) const;
+    uint32_t now() const;
+    Counters& counters();
+
+    static void configure(Table& table, double burst, double ratePerSecond);
+    static uint32_t shortfall(const Table& table, uint64_t cell, uint32_t tick);
+    static bool exhausted(const Table& table, const Slots& slots, uint32_t tick);
+    static void charge(Table& table, const Slots& slots, uint32_t tick);
+
+    std::chrono::steady_clock::time_point start;
+    uint64_t seed; // random per process, so attackers cannot aim collisions
+
+    std::unique_ptr<Table> usernames; // 128 KB each: kept off the stack
+    std::unique_ptr<Table> sources;
+
+    std::unique_ptr<Counters[]> stripes;
+};
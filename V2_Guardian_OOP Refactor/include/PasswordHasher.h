@@ -0,0 +1,78 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Argon2id (RFC 9106) password hashing, implemented in-tree.
+//
+// Hashes are stored in the usual encoded form, which carries everything
+// needed to verify them later:
+//
+//     $argon2id$v=19$m=19456,t=2,p=1$<base64 salt>$<base64 tag>
+//
+// Lanes are filled in parallel, one thread per lane. Three kernels
+// implement the block mixing, which is where the time goes:
+//   AVX2    four 64-bit words per instruction
+//   SSE2    two words per instruction
+//   SCALAR  always available
+// The best one the CPU supports is selected on first use.
+class PasswordHasher {
+public:
+    enum Kernel { SCALAR, SSE2, AVX2 };
+
+    struct Params {
+        uint32_t memoryKiB = 19 * 1024; // OWASP baseline: 19 MiB, 2 passes, 1 lane
+        uint32_t iterations = 2;
+        uint32_t lanes = 1;
+    };
+
+    static constexpr size_t SALT_LENGTH = 16;
+    static constexpr size_t TAG_LENGTH = 32;
+
+    // Ceilings for every cost parameter. A stored hash asking for more is
+    // damaged or hostile and fails to verify rather than allocating
+    // gigabytes or starting hundreds of threads.
+    static constexpr uint32_t MAX_MEMORY_KIB = 1024 * 1024;
+    static constexpr uint32_t MAX_ITERATIONS = 64;
+    static constexpr uint32_t MAX_LANES = 16;
+
+public:
+    PasswordHasher();
+    explicit PasswordHasher(Params params);
+
+    // Encoded hash with a fresh random salt
+    std::string hash(const std::string& password) const;
+
+    // True when stored is not an encoded hash or was made with other params
+    bool needsRehash(const std::string& stored) const;
+
+    const Params& getParams() const { return params; }
+
+    // Accepts an encoded hash or, for rows written before hashing existed,
+    // a legacy plaintext password (compared in constant time)
+    static bool verify(const std::string& password, const std::string& stored);
+    static bool isEncodedHash(const std::string& stored);
+
+    // Pick the largest memory cost (then pass count) that stays under
+    // target on this machine
+    static Params calibrate(std::chrono::milliseconds target, uint32_t lanes = 1,
+        uint32_t maxMemoryKiB = MAX_MEMORY_KIB);
+
+    // Raw Argon2id; secret and associatedData may be empty
+    static std::vector<uint8_t> argon2id(const std::string& password,
+        const std::vector<uint8_t>& salt, const Params& params,
+        size_t tagLength = TAG_LENGTH,
+        const std::vector<uint8_t>& secret = {},
+        const std::vector<uint8_t>& associatedData = {});
+
+    // Kernel selection. setKernel is for tests and benchmarks; it falls
+    // back to the best supported kernel
+    static Kernel activeKernel();
+    static Kernel bestSupportedKernel();
+    static void setKernel(Kernel kernel);
+
+private:
+    Params params;
+};
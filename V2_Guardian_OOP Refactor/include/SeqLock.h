@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+// A value guarded by a sequence lock, safe to place in shared memory.
+//
+// One writer at a time stores; any number of readers load without ever
+// blocking it. The writer makes the sequence odd, writes, then makes it
+// even again; a reader that saw the sequence change under it simply
+// copies again. The value is held as atomic words, so a torn copy is
+// discarded rather than being undefined behaviour.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock needs a trivially copyable value");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory needs lock-free atomics");
+
+public:
+    // Gives up after attempts copies, e.g. when a writer died mid-store
+    bool tryLoad(T& value, unsigned attempts = 1u << 16) const;
+
+    // Writers serialize among themselves, e.g. with a FileLock
+    void store(const T& value);
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> sequence{ 0 }; // odd while a store is in progress
+    std::atomic<uint64_t> words[WORDS] = {};
+};
+
+// ==================== Load / Store ====================
+
+template <typename T>
+bool SeqLock<T>::tryLoad(T& value, unsigned attempts) const
+{
+    uint64_t copy[WORDS];
+
+    for (unsigned attempt = 0; attempt < attempts; ++attempt) {
+        uint64_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        for (size_t i = 0; i < WORDS; ++i)
+            copy[i] = words[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before) {
+            std::memcpy(&value, copy, sizeof(T));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename T>
+void SeqLock<T>::store(const T& value)
+{
+    uint64_t copy[WORDS] = {};
+    std::memcpy(copy, &value, sizeof(T));
+
+    // Starting from whatever parity a crashed writer left keeps it working
+    const uint64_t writing = sequence.load(std::memory_order_relaxed) | 1;
+    sequence.store(writing, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < WORDS; ++i)
+        words[i].store(copy[i], std::memory_order_relaxed);
+
+    sequence.store(writing + 1, std::memory_order_release);
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Concurrent session table: 128-bit random token -> user id.
+//
+// The table is split into SHARD_COUNT independently locked shards (lock
+// striping), chosen by the token's high bits, so unrelated sessions never
+// contend. Each record is 8 bytes. Expiry is tracked on a per-shard timing
+// wheel with one-second slots: expire() only visits the slots that came
+// due since the last call, and lookups also reject expired entries on
+// their own, so correctness never depends on how often expire() runs.
+//
+// A wheel needs no more slots than the TTL has seconds, and a shard only
+// allocates its wheel with its first session, so a store holding no
+// sessions costs next to nothing.
+class SessionStore {
+public:
+    struct Token {
+        uint64_t high = 0;
+        uint64_t low = 0;
+
+        bool operator==(const Token& other) const { return high == other.high && low == other.low; }
+        bool operator!=(const Token& other) const { return !(*this == other); }
+
+        std::string toString() const; // 32 lowercase hex digits
+        static bool fromString(const std::string& text, Token& token);
+    };
+
+    static constexpr size_t SHARD_COUNT = 64;
+    static constexpr uint32_t MAX_WHEEL_SLOTS = 4096; // longer TTLs go round more than once
+
+public:
+    explicit SessionStore(std::chrono::seconds ttl = std::chrono::minutes(30));
+
+    SessionStore(const SessionStore&) = delete;
+    SessionStore& operator=(const SessionStore&) = delete;
+
+    // Session lifecycle
+    Token create(int userId);
+    int lookup(const Token& token); // user id, or 0 if unknown/expired; slides the TTL
+    bool revoke(const Token& token);
+
+    // Drop every session whose TTL has passed; returns how many
+    size_t expire();
+
+    size_t size() const;
+
+private:
+    struct Session {
+        int32_t userId;
+        uint32_t expiresAt; // seconds since the store was created
+    };
+
+    struct TokenHash {
+        size_t operator()(const Token& token) const {
+            return static_cast<size_t>(token.low); // already uniformly random
+        }
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<Token, Session, TokenHash> sessions;
+        std::vector<std::vector<Token>> wheel; // wheelSlots once in use
+        uint32_t wheelTime = 0; // last second already swept
+    };
+
+    Shard& shardFor(const Token& token) { return shards[token.high % SHARD_COUNT]; }
+    uint32_t now() const;
+    static Token randomToken();
+
+    std::chrono::steady_clock::time_point start;
+    uint32_t ttlSeconds;
+    uint32_t wheelSlots; // seconds per wheel turn
+    std::array<Shard, SHARD_COUNT> shards;
+};
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Named shared memory segment, mapped read-write (shm_open on POSIX,
+// a pagefile-backed file mapping on Windows). Names are plain words
+// without slashes; the platform prefix is added here.
+//
+// A POSIX segment outlives its processes until remove() is called. A
+// Windows one goes away with the last handle, so a process that wants
+// a segment to outlive it cannot guarantee that there.
+class SharedMemory {
+public:
+    SharedMemory() = default;
+    ~SharedMemory();
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    // create() fails if the name is taken; new segments read as zeros
+    bool create(const std::string& name, size_t size);
+    bool open(const std::string& name); // maps the whole existing segment
+    void close();                       // unmaps; the segment stays
+    bool isOpen() const { return base != nullptr; }
+
+    static bool remove(const std::string& name);
+
+    void* data() const { return base; }
+    size_t size() const { return length; }
+
+private:
+    static std::string systemName(const std::string& name);
+
+    void* base = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* mapping = nullptr;
+#endif
+};
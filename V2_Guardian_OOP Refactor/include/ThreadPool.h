@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed-size work-stealing thread pool.
+//
+// Every worker owns a deque: it pops its own work from the back and, when
+// that runs dry, steals from the front of the others. Tasks submitted from
+// outside the pool are spread round-robin across the deques.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F>
+    auto submit(F&& task) -> std::future<std::invoke_result_t<F>>;
+
+    size_t size() const { return workers.size(); }
+
+private:
+    using Task = std::function<void()>;
+
+    struct Queue {
+        std::deque<Task> tasks;
+        std::mutex mutex;
+    };
+
+    void enqueue(Task task);
+    bool popLocal(size_t index, Task& task);
+    bool steal(size_t index, Task& task);
+    void workerLoop(size_t index);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::atomic<bool> stopping{ false };
+    std::atomic<size_t> nextQueue{ 0 };
+    std::atomic<size_t> pending{ 0 };
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+};
+
+template <typename F>
+auto ThreadPool::submit(F&& task) -> std::future<std::invoke_result_t<F>>
+{
+    using Result = std::invoke_result_t<F>;
+
+    // std::function needs a copyable callable, packaged_task is move-only
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+    std::future<Result> future = packaged->get_future();
+
+    enqueue([packaged]() { (*packaged)(); });
+    return future;
+}
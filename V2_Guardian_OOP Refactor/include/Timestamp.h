@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Timestamps as 64-bit second counts.
+//
+// Files store "YYYY-MM-DD HH:MM:SS" in local time with no zone. A value
+// here therefore counts wall-clock seconds since 1970-01-01 00:00:00
+// local time, so parse() and format() are plain calendar arithmetic with
+// no time-zone lookups. Only now() consults the zone, at most once per
+// second per thread.
+//
+// 0 means "not set" and formats as an empty string.
+class Timestamp {
+public:
+    static constexpr size_t TEXT_LENGTH = 19; // YYYY-MM-DD HH:MM:SS
+
+public:
+    static int64_t now();
+
+    // Current time as text, formatted once per second per thread. The
+    // view stays valid until the thread's next call.
+    static std::string_view nowText();
+
+    // False unless text is exactly YYYY-MM-DD HH:MM:SS; empty text parses as 0
+    static bool parse(std::string_view text, int64_t& seconds);
+
+    static std::string format(int64_t seconds);
+
+    // Write TEXT_LENGTH characters (no terminator) to out; seconds must not be 0
+    static void formatTo(int64_t seconds, char* out);
+
+private:
+    Timestamp() = delete;
+};
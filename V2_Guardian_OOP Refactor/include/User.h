@@ -1,37 +1,56 @@
 #pragma once
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
 
+// A user is one fixed-size object plus a single heap block holding
+// username, password and email back to back. Getters return views into
+// that block, valid until the user is modified or destroyed; the
+// creation time is kept as a Timestamp second count.
 class User {
 private:
     int id;
-    std::string username;
-    std::string password;
-    std::string email;
-    std::string createdDate;
+    uint16_t usernameLength;
+    uint16_t passwordLength;
+    uint16_t emailLength;
+    int64_t createdAt;
+    std::unique_ptr<char[]> strings; // username | password | email
 
 public:
     // Constructors
     User(); // Default constructor
-    User(int id, const std::string& username, const std::string& password,
-        const std::string& email);
+    User(int id, std::string_view username, std::string_view password,
+        std::string_view email);
+    User(int id, std::string_view username, std::string_view password,
+        std::string_view email, std::string_view createdDate); // Restore persisted user
+
+    User(const User& other);
+    User(User&& other) noexcept;
+    User& operator=(const User& other);
+    User& operator=(User&& other) noexcept;
 
     // Getters
     int getId() const;
-    std::string getUsername() const;
-    std::string getPassword() const;
-    std::string getEmail() const;
-    std::string getCreatedDate() const;
+    std::string_view getUsername() const;
+    std::string_view getPassword() const;
+    std::string_view getEmail() const;
+    int64_t getCreatedAt() const;
+    std::string getCreatedDate() const; // "YYYY-MM-DD HH:MM:SS"
 
-    // Setters
+    // Setters - false, leaving the user unchanged, for a field over 65535 bytes
     void setId(int id);
-    void setUsername(const std::string& username);
-    void setPassword(const std::string& password);
-    void setEmail(const std::string& email);
+    bool setUsername(std::string_view username);
+    bool setPassword(std::string_view password);
+    bool setEmail(std::string_view email);
 
     // Validation
     bool isValid() const;
 
     // Serialization
     std::string toFileString() const;
-    static User fromFileString(const std::string& line);
-};
\ No newline at end of file
+    static User fromFileString(std::string_view line);
+
+private:
+    bool assign(std::string_view username, std::string_view password, std::string_view email);
+};
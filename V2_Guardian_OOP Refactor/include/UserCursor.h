@@ -0,0 +1,97 @@
+#pragma once
+#include "User.h"
+#include "UserRecordFile.h"
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Lazy, batched scan over a UserRecordFile.
+//
+// Records are pulled batchSize at a time, so peak memory is one batch no
+// matter how many users exist. The filter runs against the mapped record
+// before anything is copied, and only the fields in the projection mask
+// are materialized into the User (the rest stay empty).
+//
+//     for (const User& user : repo.cursor(UserCursor::ID | UserCursor::USERNAME))
+//         ...
+//
+// The cursor sees the file as it was when the cursor was opened.
+class UserCursor {
+public:
+    enum Field : unsigned {
+        ID = 1u << 0,
+        USERNAME = 1u << 1,
+        PASSWORD = 1u << 2,
+        EMAIL = 1u << 3,
+        CREATED_DATE = 1u << 4,
+        ALL = ID | USERNAME | PASSWORD | EMAIL | CREATED_DATE
+    };
+
+    // Non-owning view of one mapped record, valid only inside the filter
+    struct RecordView {
+        const UserRecordFile* file;
+        size_t index;
+
+        int id() const { return file->idAt(index); }
+        std::string_view username() const { return file->usernameAt(index); }
+        std::string_view password() const { return file->passwordAt(index); }
+        std::string_view email() const { return file->emailAt(index); }
+        std::string_view createdDate() const { return file->createdDateAt(index); }
+    };
+
+    using Filter = std::function<bool(const RecordView&)>;
+
+    static constexpr size_t DEFAULT_BATCH_SIZE = 256;
+
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = User;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const User*;
+        using reference = const User&;
+
+        iterator() = default;
+        explicit iterator(UserCursor* cursor);
+
+        reference operator*() const { return cursor->batch[position]; }
+        pointer operator->() const { return &cursor->batch[position]; }
+        iterator& operator++();
+        void operator++(int) { ++*this; }
+
+        bool operator==(const iterator& other) const { return cursor == other.cursor; }
+        bool operator!=(const iterator& other) const { return cursor != other.cursor; }
+
+    private:
+        UserCursor* cursor = nullptr; // nullptr once exhausted
+        size_t position = 0;
+    };
+
+public:
+    UserCursor(const std::string& path, unsigned fields = ALL, Filter filter = nullptr,
+        size_t batchSize = DEFAULT_BATCH_SIZE);
+
+    UserCursor(const UserCursor&) = delete;
+    UserCursor& operator=(const UserCursor&) = delete;
+
+    // Explicit batch API - false once no records are left
+    bool next(std::vector<User>& out);
+
+    // Range API - single pass
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+private:
+    bool fetch();
+    User project(size_t index) const;
+
+    UserRecordFile file;
+    unsigned fields;
+    Filter filter;
+    size_t batchSize;
+    size_t scanned = 0;        // next record index in the file
+    std::vector<User> batch;   // current batch, reused between fetches
+};
@@ -0,0 +1,100 @@
+#pragma once
+#include "User.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// On-disk layout (little-endian, version 1):
+//
+//   FileHeader                      fixed 40 bytes
+//   RecordEntry[recordCount]        fixed 40 bytes each, sorted by id
+//   string heap                     interned, not NUL-terminated
+//
+// Every string field of a record is a {offset, length} reference into the
+// heap, so reading a field is a pointer into the mapped file.
+class UserRecordFile {
+public:
+    static constexpr char MAGIC[4] = { 'G', 'U', 'R', 'F' };
+    static constexpr uint16_t VERSION = 1;
+
+    struct StringRef {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct FileHeader {
+        char magic[4];
+        uint16_t version;
+        uint16_t entrySize;
+        uint32_t recordCount;
+        uint32_t reserved;
+        uint64_t entriesOffset;
+        uint64_t heapOffset;
+        uint64_t heapSize;
+    };
+
+    struct RecordEntry {
+        int32_t id;
+        uint32_t reserved;
+        StringRef username;
+        StringRef password;
+        StringRef email;
+        StringRef createdDate;
+    };
+
+    static_assert(sizeof(FileHeader) == 40, "FileHeader layout changed");
+    static_assert(sizeof(RecordEntry) == 40, "RecordEntry layout changed");
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+public:
+    UserRecordFile() = default;
+    ~UserRecordFile();
+
+    UserRecordFile(const UserRecordFile&) = delete;
+    UserRecordFile& operator=(const UserRecordFile&) = delete;
+
+    // Mapping
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    // Record access (index in [0, size()))
+    size_t size() const { return header ? header->recordCount : 0; }
+    int idAt(size_t index) const { return entries[index].id; }
+    std::string_view usernameAt(size_t index) const { return view(entries[index].username); }
+    std::string_view passwordAt(size_t index) const { return view(entries[index].password); }
+    std::string_view emailAt(size_t index) const { return view(entries[index].email); }
+    std::string_view createdDateAt(size_t index) const { return view(entries[index].createdDate); }
+    User userAt(size_t index) const;
+
+    // Lookups - return npos when not found, never allocate
+    size_t findById(int id) const;
+    size_t findByUsername(std::string_view username) const;
+    size_t findByEmail(std::string_view email) const;
+
+    // Writing - builds the whole file in a temp and renames it into place
+    static bool write(const std::string& path, const std::vector<User>& users);
+
+    // Lossless conversion from the CSV produced by User::toFileString;
+    // writes nothing and returns false if any row fails to parse
+    static bool convertFromCsv(const std::string& csvPath, const std::string& path);
+
+private:
+    std::string_view view(StringRef ref) const {
+        return std::string_view(heap + ref.offset, ref.length);
+    }
+
+    const FileHeader* header = nullptr;
+    const RecordEntry* entries = nullptr;
+    const char* heap = nullptr;
+
+    const void* mapping = nullptr;
+    size_t mappingSize = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mapHandle = nullptr;
+#endif
+};
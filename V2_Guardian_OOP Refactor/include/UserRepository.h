@@ -1,33 +1,99 @@
 #pragma once
+#include "AtomicFile.h"
+#include "BloomFilter.h"
+#include "BPlusTreeIndex.h"
+#include "FileLock.h"
+#include "GroupCommitWriter.h"
 #include "User.h"
+#include "UserCursor.h"
+#include "UserRecordFile.h"
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 
+// Thread-safe. create, update and remove go through a group-commit writer:
+// changes from concurrent callers are applied as one rewrite of the data
+// file and one sync, and each call returns once its change is durable.
+//
+// Several processes may share one data directory: writes hold an
+// exclusive lock on <name>.lock and reads a shared one, and a reader
+// reopens the data file and indexes whenever another instance has
+// replaced them since it last looked.
+//
+// A Bloom filter per index answers lookups for keys that were never
+// stored - most registrations and failed logins - without reading a
+// single index page.
 class UserRepository {
 private:
+    struct Change {
+        enum Kind { CREATE, UPDATE, REMOVE } kind;
+        User user;            // CREATE, UPDATE
+        std::string username; // REMOVE
+        int* createdId;       // CREATE: receives the id once durable
+    };
+
     std::string filePath;
+    mutable UserRecordFile records;         // read-only mapping of filePath
+    mutable BPlusTreeIndex usernameIndex;   // username -> id, <name>.username.idx
+    mutable BPlusTreeIndex emailIndex;      // email -> id, <name>.email.idx
+    mutable BloomFilter usernameFilter;     // <name>.username.bloom
+    mutable BloomFilter emailFilter;        // <name>.email.bloom
+    mutable AtomicFile::Stamp recordsStamp; // filePath as the five above last saw it
+    mutable std::mutex stateMutex;          // guards the six above
+    mutable FileLock fileLock;              // <name>.lock, shared with other processes
+
+    GroupCommitWriter<Change> writer; // last: drains before the rest goes away
 
 public:
-    // Constructor
-    explicit UserRepository(const std::string& filePath = "data/users.txt");
+    // Constructor - migrates a legacy CSV next to filePath on first run.
+    // A CSV with a row that does not parse is left as it is, and every
+    // write is refused until it is fixed and the repository reopened.
+    explicit UserRepository(const std::string& filePath = "data/users.dat",
+        GroupCommitOptions commitOptions = GroupCommitOptions());
 
-    // CRUD operations
-    bool create(const User& user);
-    User* read(const std::string& username) const;
-    std::vector<User> getAllUsers() const;
+    // CRUD operations - writes block until durable. A username or email
+    // longer than BPlusTreeIndex::MAX_KEY_LENGTH is refused.
+    //
+    // create ignores user's id and assigns the next free one under the
+    // file lock, so concurrent callers and processes never collide. It
+    // returns the id, or 0 if the user was refused.
+    int create(const User& user);
+    User* read(const std::string& username) const; // caller owns the result
+    std::vector<User> getAllUsers() const; // small tables only - prefer cursor()
     bool update(const User& user);
     bool remove(const std::string& username);
 
+    // Indexed lookups
+    User* readByEmail(const std::string& email) const; // caller owns the result
+    std::vector<User> findByUsernamePrefix(const std::string& prefix,
+        size_t limit = SIZE_MAX) const;
+
+    // Streaming scan with filter and projection pushdown
+    UserCursor cursor(unsigned fields = UserCursor::ALL, UserCursor::Filter filter = nullptr,
+        size_t batchSize = UserCursor::DEFAULT_BATCH_SIZE) const;
+
+    // Group-commit statistics
+    size_t batchesCommitted() const { return writer.batchesCommitted(); }
+    size_t changesCommitted() const { return writer.requestsCommitted(); }
+
     // Helper methods
-    bool exists(const std::string& username) const;
+    bool exists(std::string_view username) const;
+    bool emailExists(std::string_view email) const;
     int count() const;
-    int getNextId() const;
+    int getNextId() const; // a guess: create assigns the real id
 
     // Authentication helper
     bool validateCredentials(const std::string& username,
         const std::string& password) const;
 
 private:
+    // Group commit - runs on the writer thread
+    void commitBatch(std::vector<Change>& batch, std::vector<char>& accepted);
+
+    // Cross-process coherence - call with fileLock held
+    void reloadIfChanged(bool writer) const;
+
     // I/O helpers
     std::vector<User> loadFromFile() const;
     bool saveToFile(const std::vector<User>& users) const;
@@ -35,4 +101,19 @@ private:
     // File utilities
     bool fileExists() const;
     void createFileIfNotExists() const;
+    bool mapRecords() const;
+    std::string legacyCsvPath() const;
+
+    // Index utilities
+    void openIndexes() const;
+    bool rebuildIndexes() const;
+    std::string indexPath(const std::string& field) const;
+    size_t findRecord(const BPlusTreeIndex& index, const BloomFilter& filter, std::string_view key,
+        std::string_view (UserRecordFile::*field)(size_t) const) const;
+
+    // Filter utilities
+    void openFilters() const;
+    bool rebuildFilters(const std::vector<User>& users) const;
+    BloomFilter::Source filterSource(size_t recordCount) const;
+    std::string filterPath(const std::string& field) const;
 };
\ No newline at end of file
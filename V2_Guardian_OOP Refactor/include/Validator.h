@@ -1,25 +1,35 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 
 class Validator {
 public:
+    enum class Field { USERNAME, PASSWORD, EMAIL };
+
     // Username validations
-    static bool isValidUsername(const std::string& username);
-    static bool isUsernameLength(const std::string& username);
-    static bool hasNoSpaces(const std::string& username);
+    static bool isValidUsername(std::string_view username);
+    static bool isUsernameLength(std::string_view username);
+    static bool hasNoSpaces(std::string_view username);
 
     // Password validations
-    static bool isValidPassword(const std::string& password);
-    static bool isPasswordStrong(const std::string& password);
+    static bool isValidPassword(std::string_view password);
+    static bool isPasswordStrong(std::string_view password);
 
     // Email validations
-    static bool isValidEmail(const std::string& email);
-    static bool hasAtSymbol(const std::string& email);
+    static bool isValidEmail(std::string_view email);
+    static bool hasAtSymbol(std::string_view email);
 
     // Helper methods
-    static bool isEmpty(const std::string& str);
-    static bool isLengthInRange(const std::string& str, int min, int max);
-    static bool containsOnlyAlphanumeric(const std::string& str);
+    static bool isEmpty(std::string_view str);
+    static bool isLengthInRange(std::string_view str, int min, int max);
+    static bool containsOnlyAlphanumeric(std::string_view str);
+
+    // Validate a whole column at once (bulk imports): valid[i] is 1 or 0.
+    // Returns the number of valid values
+    static size_t validateColumn(Field field, const std::vector<std::string_view>& values,
+        std::vector<uint8_t>& valid);
 
     // Display validation errors
     static std::string getValidationErrors(const std::string& field,
@@ -27,4 +37,4 @@ public:
 
 private:
 	Validator() = delete; // Prevent instantiation - all methods are static
-};
\ No newline at end of file
+};
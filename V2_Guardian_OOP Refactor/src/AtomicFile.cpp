@@ -0,0 +1,213 @@
+#include "../include/AtomicFile.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#include <system_error>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+    const std::string TEMP_SUFFIX = ".tmp.";
+
+}
+
+// ==================== Replace ====================
+
+bool AtomicFile::replace(const std::string& path, std::initializer_list<std::string_view> parts)
+{
+    const std::string temp = tempPath(path);
+
+    if (!writeDurably(temp, parts) || !renameOver(temp, path)) {
+        std::remove(temp.c_str());
+        return false;
+    }
+
+    // The rename itself is only durable once the directory entry is
+    return syncDirectory(path);
+}
+
+std::string AtomicFile::tempPath(const std::string& path)
+{
+    static std::atomic<unsigned> counter{ 0 };
+
+#ifdef _WIN32
+    const unsigned long pid = GetCurrentProcessId();
+#else
+    const unsigned long pid = static_cast<unsigned long>(getpid());
+#endif
+
+    return path + TEMP_SUFFIX + std::to_string(pid) + "." + std::to_string(counter++);
+}
+
+bool AtomicFile::writeDurably(const std::string& path, std::initializer_list<std::string_view> parts)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    bool ok = true;
+    for (std::string_view part : parts) {
+        while (ok && !part.empty()) {
+            DWORD chunk = static_cast<DWORD>(std::min<size_t>(part.size(), 1u << 30));
+            DWORD written = 0;
+            ok = WriteFile(file, part.data(), chunk, &written, nullptr) != 0 && written > 0;
+            part.remove_prefix(written);
+        }
+    }
+
+    ok = ok && FlushFileBuffers(file) != 0;
+    return CloseHandle(file) != 0 && ok;
+#else
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+
+    bool ok = true;
+    for (std::string_view part : parts) {
+        while (ok && !part.empty()) {
+            ssize_t written = ::write(fd, part.data(), part.size());
+            if (written < 0 && errno == EINTR)
+                continue;
+            ok = written > 0;
+            if (ok)
+                part.remove_prefix(static_cast<size_t>(written));
+        }
+    }
+
+    // Only data has to reach the disk; fdatasync skips the metadata flush
+#ifdef __APPLE__
+    ok = ok && fcntl(fd, F_FULLFSYNC) == 0;
+#else
+    ok = ok && fdatasync(fd) == 0;
+#endif
+    return ::close(fd) == 0 && ok;
+#endif
+}
+
+bool AtomicFile::sync(const std::string& path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    bool ok = FlushFileBuffers(file) != 0;
+    return CloseHandle(file) != 0 && ok;
+#else
+    int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+#ifdef __APPLE__
+    bool ok = fcntl(fd, F_FULLFSYNC) == 0;
+#else
+    bool ok = fdatasync(fd) == 0;
+#endif
+    return ::close(fd) == 0 && ok;
+#endif
+}
+
+bool AtomicFile::renameOver(const std::string& from, const std::string& to)
+{
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(),
+        MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+bool AtomicFile::syncDirectory(const std::string& path)
+{
+#ifdef _WIN32
+    (void)path; // MOVEFILE_WRITE_THROUGH already flushed the rename
+    return true;
+#else
+    std::string directory = fs::path(path).parent_path().string();
+    if (directory.empty())
+        directory = ".";
+
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    bool ok = fsync(fd) == 0;
+    return ::close(fd) == 0 && ok;
+#endif
+}
+
+// ==================== Recovery ====================
+
+size_t AtomicFile::recover(const std::string& path, const std::string& legacyTempPath)
+{
+    size_t recovered = 0;
+    std::error_code error;
+
+    if (!legacyTempPath.empty() && fs::exists(legacyTempPath, error)) {
+        if (!fs::exists(path, error) && renameOver(legacyTempPath, path))
+            syncDirectory(path);
+        else
+            fs::remove(legacyTempPath, error);
+        ++recovered;
+    }
+
+    fs::path target(path);
+    fs::path directory = target.parent_path().empty() ? fs::path(".") : target.parent_path();
+    const std::string prefix = target.filename().string() + TEMP_SUFFIX;
+
+    for (const fs::directory_entry& entry : fs::directory_iterator(directory, error)) {
+        if (entry.path().filename().string().compare(0, prefix.size(), prefix) == 0
+            && fs::remove(entry.path(), error))
+            ++recovered;
+    }
+
+    return recovered;
+}
+
+// ==================== Change detection ====================
+
+AtomicFile::Stamp AtomicFile::stamp(const std::string& path)
+{
+    Stamp result;
+
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data)
+        || (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+        return result;
+
+    result.exists = true;
+    result.size = (uint64_t(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+    result.modified = int64_t((uint64_t(data.ftLastWriteTime.dwHighDateTime) << 32)
+        | data.ftLastWriteTime.dwLowDateTime);
+#else
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+        return result;
+
+    result.exists = true;
+    result.identity = static_cast<uint64_t>(st.st_ino);
+    result.size = static_cast<uint64_t>(st.st_size);
+#ifdef __APPLE__
+    result.modified = int64_t(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    result.modified = int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+#endif
+
+    return result;
+}
@@ -0,0 +1,209 @@
+#include "../include/AuthManager.h"
+#include "../include/Screen.h"
+#include "../include/Validator.h"
+#include <iostream>
+
+// ==================== Constructor / Destructor ====================
+
+AuthManager::AuthManager(UserRepository& repo, const PasswordHasher& hasher,
+    LoginThrottleOptions throttleOptions)
+    : repository(repo), currentUser(nullptr), hasher(hasher), throttle(throttleOptions) {}
+
+AuthManager::~AuthManager()
+{
+    delete currentUser;
+}
+
+// ==================== Interactive operations ====================
+
+bool AuthManager::registerUser()
+{
+    Screen::printHeader("REGISTRATION");
+
+    std::string email = promptEmail();
+    std::string username = promptUsername();
+    std::string password = promptPassword();
+
+    if (Screen::getPasswordInput("Confirm Password: ") != password) {
+        Screen::printError("Passwords do not match!");
+        return false;
+    }
+
+    if (!registerUser(username, password, email)) {
+        Screen::printError("Registration failed. Username or email already in use.");
+        return false;
+    }
+
+    Screen::printSuccess("Registration successful!");
+    return true;
+}
+
+bool AuthManager::login()
+{
+    Screen::printHeader("LOGIN");
+
+    std::string username = Screen::getInput("Enter Username: ");
+    std::string password = Screen::getPasswordInput("Enter Password: ");
+
+    if (!login(username, password)) {
+        if (throttle.throttled(username, ""))
+            Screen::printError("Too many failed attempts. Please wait before trying again.");
+        else
+            Screen::printError("Invalid username or password.");
+        return false;
+    }
+
+    Screen::printSuccess("Login successful!");
+    return true;
+}
+
+void AuthManager::logout()
+{
+    delete currentUser;
+    currentUser = nullptr;
+}
+
+// ==================== Non-interactive operations ====================
+
+bool AuthManager::registerUser(const std::string& username,
+    const std::string& password,
+    const std::string& email)
+{
+    if (!validateRegistrationInput(username, password, email))
+        return false;
+
+    if (repository.exists(username) || repository.emailExists(email))
+        return false;
+
+    // The repository assigns the id when it commits the user
+    User user(0, username, hasher.hash(password), email);
+    return repository.create(user) != 0;
+}
+
+bool AuthManager::login(const std::string& username, const std::string& password,
+    const std::string& source)
+{
+    User* user = authenticate(username, password, source);
+    if (!user)
+        return false;
+
+    delete currentUser;
+    currentUser = user;
+    return true;
+}
+
+User* AuthManager::authenticate(const std::string& username, const std::string& password,
+    const std::string& source)
+{
+    if (throttle.admit(username, source) != LoginThrottle::Verdict::ALLOW)
+        return nullptr;
+
+    // Unknown usernames are charged too, or probing for them would be free
+    User* user = repository.read(username);
+    if (!user || !PasswordHasher::verify(password, std::string(user->getPassword()))) {
+        throttle.recordFailure(username, source);
+        delete user;
+        return nullptr;
+    }
+
+    rehashIfNeeded(*user, password);
+    return user;
+}
+
+// ==================== Token sessions ====================
+
+bool AuthManager::openSession(const std::string& username, const std::string& password,
+    SessionStore::Token& token, const std::string& source)
+{
+    User* user = authenticate(username, password, source);
+    if (!user)
+        return false;
+
+    token = sessions.create(user->getId());
+    delete user;
+    return true;
+}
+
+int AuthManager::sessionUserId(const SessionStore::Token& token)
+{
+    return sessions.lookup(token);
+}
+
+bool AuthManager::closeSession(const SessionStore::Token& token)
+{
+    return sessions.revoke(token);
+}
+
+void AuthManager::rehashIfNeeded(User& user, const std::string& password)
+{
+    // Plaintext rows from before hashing, or hashes made with older cost
+    // parameters, are upgraded transparently while the password is known
+    if (!hasher.needsRehash(std::string(user.getPassword())))
+        return;
+
+    user.setPassword(hasher.hash(password));
+    repository.update(user);
+}
+
+// ==================== Display ====================
+
+void AuthManager::displayCurrentUserInfo() const
+{
+    if (!currentUser) {
+        Screen::printWarning("No user is logged in.");
+        return;
+    }
+
+    Screen::printHeader("YOUR INFORMATION");
+    std::cout << "  ID:       " << currentUser->getId() << std::endl;
+    std::cout << "  Username: " << currentUser->getUsername() << std::endl;
+    std::cout << "  Email:    " << currentUser->getEmail() << std::endl;
+    std::cout << "  Created:  " << currentUser->getCreatedDate() << std::endl;
+    Screen::printLine();
+}
+
+// ==================== Input helpers ====================
+
+std::string AuthManager::promptUsername()
+{
+    while (true) {
+        std::string username = Screen::getInput("Enter Username: ");
+        if (Validator::isValidUsername(username))
+            return username;
+
+        Screen::printError(Validator::getValidationErrors("username", username));
+    }
+}
+
+std::string AuthManager::promptEmail()
+{
+    while (true) {
+        std::string email = Screen::getInput("Enter Email: ");
+        if (Validator::isValidEmail(email))
+            return email;
+
+        Screen::printError(Validator::getValidationErrors("email", email));
+    }
+}
+
+std::string AuthManager::promptPassword()
+{
+    while (true) {
+        std::string password = Screen::getPasswordInput("Enter Password: ");
+        if (Validator::isValidPassword(password))
+            return password;
+
+        Screen::printError(Validator::getValidationErrors("password", password));
+    }
+}
+
+// ==================== Validation ====================
+
+bool AuthManager::validateRegistrationInput(const std::string& username,
+    const std::string& password,
+    const std::string& email)
+{
+    return Validator::isValidUsername(username)
+        && Validator::isValidPassword(password)
+        && Validator::isValidEmail(email);
+}
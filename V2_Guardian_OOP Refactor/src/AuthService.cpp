@@ -0,0 +1,96 @@
+#include "../include/AuthService.h"
+#include <utility>
+
+// ==================== Constructor ====================
+
+AuthService::AuthService(UserRepository& repo, size_t threadCount,
+    const PasswordHasher& hasher, LoginThrottleOptions throttleOptions)
+    : repository(repo), hasher(hasher), throttle(throttleOptions), pool(threadCount)
+{
+    refresh();
+}
+
+// ==================== Verification ====================
+
+std::future<AuthService::Result> AuthService::verify(Credentials credentials)
+{
+    return pool.submit([this, credentials = std::move(credentials)]() {
+        return verifyNow(credentials);
+    });
+}
+
+std::vector<std::future<AuthService::Result>> AuthService::verifyBatch(
+    const std::vector<Credentials>& batch)
+{
+    std::vector<std::future<Result>> results;
+    results.reserve(batch.size());
+
+    for (const Credentials& credentials : batch)
+        results.push_back(verify(credentials));
+
+    return results;
+}
+
+AuthService::Result AuthService::verifyNow(const Credentials& credentials)
+{
+    if (throttle.admit(credentials.username, credentials.source) != LoginThrottle::Verdict::ALLOW)
+        return Result{ false, 0, true };
+
+    Entry entry;
+    bool known;
+    {
+        std::shared_lock<std::shared_mutex> lock(indexMutex);
+
+        auto it = index.find(credentials.username);
+        known = it != index.end();
+        if (known)
+            entry = it->second; // copy out so hashing runs without the lock
+    }
+
+    // Unknown usernames are charged too, or probing for them would be free
+    if (!known || !PasswordHasher::verify(credentials.password, entry.storedHash)) {
+        throttle.recordFailure(credentials.username, credentials.source);
+        return Result{};
+    }
+
+    if (hasher.needsRehash(entry.storedHash))
+        rehash(credentials.username, entry.id, credentials.password);
+
+    return Result{ true, entry.id };
+}
+
+// ==================== Index maintenance ====================
+
+void AuthService::refresh()
+{
+    std::unordered_map<std::string, Entry> fresh;
+    for (const User& user : repository.cursor(UserCursor::ID | UserCursor::USERNAME | UserCursor::PASSWORD))
+        fresh.emplace(user.getUsername(), Entry{ user.getId(), std::string(user.getPassword()) });
+
+    std::unique_lock<std::shared_mutex> lock(indexMutex);
+    index.swap(fresh);
+}
+
+void AuthService::rehash(const std::string& username, int id, const std::string& password)
+{
+    std::string upgraded = hasher.hash(password);
+
+    User* user = repository.read(username);
+    if (!user || user->getId() != id) {
+        delete user;
+        return;
+    }
+
+    // Another worker may have upgraded it already. UserRepository is
+    // thread-safe, so two racing upgrades each store a valid hash and the
+    // index keeps one of them until the next refresh().
+    if (hasher.needsRehash(std::string(user->getPassword()))) {
+        user->setPassword(upgraded);
+        if (repository.update(*user)) {
+            std::unique_lock<std::shared_mutex> lock(indexMutex);
+            index[username] = Entry{ id, upgraded };
+        }
+    }
+
+    delete user;
+}
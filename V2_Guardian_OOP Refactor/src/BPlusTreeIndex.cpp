@@ -0,0 +1,424 @@
+#include "../include/BPlusTreeIndex.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+    constexpr char INDEX_MAGIC[4] = { 'G', 'B', 'P', 'T' };
+    constexpr uint32_t INDEX_VERSION = 2;
+
+}
+
+// ==================== File management ====================
+
+bool BPlusTreeIndex::open(const std::string& path)
+{
+    close();
+
+    this->path = path;
+    file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+
+    if (file.is_open()) {
+        file.read(reinterpret_cast<char*>(&meta), sizeof(meta));
+        if (file && std::memcmp(meta.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0
+            && meta.version == INDEX_VERSION)
+            return true;
+
+        file.close();
+    }
+
+    // Missing or unreadable: start an empty tree (callers rebuild from data)
+    file.open(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+
+    return rebuild({});
+}
+
+void BPlusTreeIndex::close()
+{
+    if (file.is_open())
+        file.close();
+
+    meta = Meta{};
+}
+
+// ==================== Point operations ====================
+
+bool BPlusTreeIndex::insert(std::string_view key, int32_t value)
+{
+    if (!isOpen() || key.size() > MAX_KEY_LENGTH)
+        return false;
+
+    Split split;
+    bool added = false;
+
+    if (!insertInto(meta.rootPage, makeEntry(key, value), split, added))
+        return false;
+
+    if (split.happened) {
+        // Grow the tree by one level
+        Page root{};
+        root.header.isLeaf = 0;
+        root.header.count = 1;
+        root.header.firstChild = meta.rootPage;
+        root.entries[0] = split.separator;
+
+        uint32_t rootPage = allocatePage();
+        if (!writePage(rootPage, root))
+            return false;
+
+        meta.rootPage = rootPage;
+    }
+
+    if (added)
+        ++meta.keyCount;
+
+    return writeMeta();
+}
+
+bool BPlusTreeIndex::erase(std::string_view key)
+{
+    uint32_t pageId;
+    Page leaf;
+
+    if (!findLeaf(key, pageId, leaf))
+        return false;
+
+    size_t pos = lowerBound(leaf, key);
+    if (pos == leaf.header.count || keyOf(leaf.entries[pos]) != key)
+        return false;
+
+    std::memmove(&leaf.entries[pos], &leaf.entries[pos + 1],
+        (leaf.header.count - pos - 1) * sizeof(Entry));
+    --leaf.header.count;
+
+    if (!writePage(pageId, leaf))
+        return false;
+
+    --meta.keyCount;
+    return writeMeta();
+}
+
+bool BPlusTreeIndex::find(std::string_view key, int32_t& value) const
+{
+    uint32_t pageId;
+    Page leaf;
+
+    if (!findLeaf(key, pageId, leaf))
+        return false;
+
+    size_t pos = lowerBound(leaf, key);
+    if (pos == leaf.header.count || keyOf(leaf.entries[pos]) != key)
+        return false;
+
+    value = leaf.entries[pos].value;
+    return true;
+}
+
+std::vector<int32_t> BPlusTreeIndex::prefixScan(std::string_view prefix, size_t limit) const
+{
+    std::vector<int32_t> values;
+
+    uint32_t pageId;
+    Page leaf;
+
+    if (!findLeaf(prefix, pageId, leaf))
+        return values;
+
+    size_t pos = lowerBound(leaf, prefix);
+
+    while (values.size() < limit) {
+        if (pos == leaf.header.count) {
+            if (leaf.header.nextLeaf == 0 || !readPage(leaf.header.nextLeaf, leaf))
+                break;
+            pos = 0;
+            continue;
+        }
+
+        std::string_view key = keyOf(leaf.entries[pos]);
+        if (key.substr(0, prefix.size()) != prefix)
+            break;
+
+        values.push_back(leaf.entries[pos].value);
+        ++pos;
+    }
+
+    return values;
+}
+
+bool BPlusTreeIndex::rebuild(std::vector<std::pair<std::string, int32_t>> entries,
+    const AtomicFile::Stamp& source)
+{
+    if (!isOpen())
+        return false;
+
+    // Refuse rather than leave a key out; the tree is untouched
+    for (const auto& entry : entries) {
+        if (entry.first.size() > MAX_KEY_LENGTH)
+            return false;
+    }
+
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end(),
+        [](const auto& a, const auto& b) { return a.first == b.first; }), entries.end());
+
+    std::memcpy(meta.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    meta.version = INDEX_VERSION;
+    meta.pageCount = 1;
+    meta.keyCount = 0;
+    meta.sourceIdentity = meta.sourceSize = 0;
+    meta.sourceModified = 0;
+
+    // Bottom level: full leaves linked left to right
+    std::vector<std::pair<Entry, uint32_t>> level; // (first key, page)
+    size_t next = 0;
+
+    do {
+        Page leaf{};
+        leaf.header.isLeaf = 1;
+
+        while (next < entries.size() && leaf.header.count < CAPACITY) {
+            const auto& entry = entries[next++];
+            leaf.entries[leaf.header.count++] = makeEntry(entry.first, entry.second);
+            ++meta.keyCount;
+        }
+
+        uint32_t pageId = allocatePage();
+        if (!level.empty()) {
+            Page previous;
+            if (!readPage(level.back().second, previous))
+                return false;
+            previous.header.nextLeaf = pageId;
+            if (!writePage(level.back().second, previous))
+                return false;
+        }
+
+        if (!writePage(pageId, leaf))
+            return false;
+
+        level.emplace_back(leaf.entries[0], pageId);
+    } while (next < entries.size());
+
+    // Internal levels: each node takes up to CAPACITY + 1 children
+    while (level.size() > 1) {
+        std::vector<std::pair<Entry, uint32_t>> parents;
+
+        for (size_t i = 0; i < level.size(); i += CAPACITY + 1) {
+            size_t end = std::min(level.size(), i + CAPACITY + 1);
+
+            Page node{};
+            node.header.isLeaf = 0;
+            node.header.firstChild = level[i].second;
+
+            for (size_t j = i + 1; j < end; ++j) {
+                Entry separator = level[j].first;
+                separator.value = static_cast<int32_t>(level[j].second);
+                node.entries[node.header.count++] = separator;
+            }
+
+            uint32_t pageId = allocatePage();
+            if (!writePage(pageId, node))
+                return false;
+
+            parents.emplace_back(level[i].first, pageId);
+        }
+
+        level.swap(parents);
+    }
+
+    meta.rootPage = level.front().second;
+    return writeMeta() && setSource(source);
+}
+
+// ==================== Source ====================
+
+bool BPlusTreeIndex::builtFrom(const AtomicFile::Stamp& source) const
+{
+    return isOpen() && source.exists && meta.sourceIdentity == source.identity
+        && meta.sourceSize == source.size && meta.sourceModified == source.modified;
+}
+
+// The pages reach the disk before the metadata that vouches for them
+bool BPlusTreeIndex::setSource(const AtomicFile::Stamp& source)
+{
+    if (!isOpen() || !sync())
+        return false;
+
+    meta.sourceIdentity = source.identity;
+    meta.sourceSize = source.size;
+    meta.sourceModified = source.modified;
+    return writeMeta() && sync();
+}
+
+// ==================== Page I/O ====================
+
+bool BPlusTreeIndex::readPage(uint32_t pageId, Page& page) const
+{
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(pageId) * PAGE_SIZE);
+    file.read(reinterpret_cast<char*>(&page), sizeof(Page));
+    return static_cast<bool>(file);
+}
+
+bool BPlusTreeIndex::writePage(uint32_t pageId, const Page& page)
+{
+    file.clear();
+    file.seekp(static_cast<std::streamoff>(pageId) * PAGE_SIZE);
+    file.write(reinterpret_cast<const char*>(&page), sizeof(Page));
+    return static_cast<bool>(file);
+}
+
+bool BPlusTreeIndex::writeMeta()
+{
+    char page[PAGE_SIZE] = {};
+    std::memcpy(page, &meta, sizeof(meta));
+
+    file.clear();
+    file.seekp(0);
+    file.write(page, sizeof(page));
+    file.flush();
+    return static_cast<bool>(file);
+}
+
+bool BPlusTreeIndex::sync()
+{
+    file.flush();
+    return static_cast<bool>(file) && AtomicFile::sync(path);
+}
+
+uint32_t BPlusTreeIndex::allocatePage()
+{
+    return meta.pageCount++;
+}
+
+// ==================== Tree helpers ====================
+
+std::string_view BPlusTreeIndex::keyOf(const Entry& entry)
+{
+    return std::string_view(entry.key, entry.keyLength);
+}
+
+BPlusTreeIndex::Entry BPlusTreeIndex::makeEntry(std::string_view key, int32_t value)
+{
+    Entry entry{};
+    std::memcpy(entry.key, key.data(), key.size());
+    entry.keyLength = static_cast<uint32_t>(key.size());
+    entry.value = value;
+    return entry;
+}
+
+size_t BPlusTreeIndex::lowerBound(const Page& page, std::string_view key)
+{
+    const Entry* begin = page.entries;
+    const Entry* end = page.entries + page.header.count;
+
+    return std::lower_bound(begin, end, key,
+        [](const Entry& entry, std::string_view value) { return keyOf(entry) < value; }) - begin;
+}
+
+size_t BPlusTreeIndex::childSlot(const Page& page, std::string_view key)
+{
+    // Slot 0 is firstChild, slot i + 1 is the child right of entries[i]
+    const Entry* begin = page.entries;
+    const Entry* end = page.entries + page.header.count;
+
+    return std::upper_bound(begin, end, key,
+        [](std::string_view value, const Entry& entry) { return value < keyOf(entry); }) - begin;
+}
+
+uint32_t BPlusTreeIndex::childAt(const Page& page, size_t slot)
+{
+    return slot == 0 ? page.header.firstChild
+                     : static_cast<uint32_t>(page.entries[slot - 1].value);
+}
+
+bool BPlusTreeIndex::findLeaf(std::string_view key, uint32_t& pageId, Page& page) const
+{
+    if (!isOpen())
+        return false;
+
+    pageId = meta.rootPage;
+    if (!readPage(pageId, page))
+        return false;
+
+    while (!page.header.isLeaf) {
+        pageId = childAt(page, childSlot(page, key));
+        if (!readPage(pageId, page))
+            return false;
+    }
+
+    return true;
+}
+
+bool BPlusTreeIndex::insertInto(uint32_t pageId, const Entry& entry, Split& split, bool& added)
+{
+    Page page;
+    if (!readPage(pageId, page))
+        return false;
+
+    std::string_view key = keyOf(entry);
+    std::vector<Entry> entries(page.entries, page.entries + page.header.count);
+
+    if (page.header.isLeaf) {
+        size_t pos = lowerBound(page, key);
+
+        if (pos < entries.size() && keyOf(entries[pos]) == key) {
+            page.entries[pos].value = entry.value;
+            return writePage(pageId, page);
+        }
+
+        entries.insert(entries.begin() + pos, entry);
+        added = true;
+    }
+    else {
+        size_t slot = childSlot(page, key);
+
+        Split childSplit;
+        if (!insertInto(childAt(page, slot), entry, childSplit, added))
+            return false;
+
+        if (!childSplit.happened)
+            return true;
+
+        entries.insert(entries.begin() + slot, childSplit.separator);
+    }
+
+    if (entries.size() <= CAPACITY) {
+        std::copy(entries.begin(), entries.end(), page.entries);
+        page.header.count = static_cast<uint16_t>(entries.size());
+        return writePage(pageId, page);
+    }
+
+    // Overflow: move the upper half into a new right sibling
+    Page right{};
+    right.header.isLeaf = page.header.isLeaf;
+
+    size_t mid = entries.size() / 2;
+    uint32_t rightId = allocatePage();
+
+    if (page.header.isLeaf) {
+        std::copy(entries.begin() + mid, entries.end(), right.entries);
+        right.header.count = static_cast<uint16_t>(entries.size() - mid);
+        right.header.nextLeaf = page.header.nextLeaf;
+        page.header.nextLeaf = rightId;
+
+        split.separator = entries[mid];
+    }
+    else {
+        // The middle key moves up; its child becomes the right node's firstChild
+        right.header.firstChild = static_cast<uint32_t>(entries[mid].value);
+        std::copy(entries.begin() + mid + 1, entries.end(), right.entries);
+        right.header.count = static_cast<uint16_t>(entries.size() - mid - 1);
+
+        split.separator = entries[mid];
+    }
+
+    split.separator.value = static_cast<int32_t>(rightId);
+    split.happened = true;
+
+    std::copy(entries.begin(), entries.begin() + mid, page.entries);
+    page.header.count = static_cast<uint16_t>(mid);
+
+    return writePage(rightId, right) && writePage(pageId, page);
+}
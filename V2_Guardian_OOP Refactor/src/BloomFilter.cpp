@@ -0,0 +1,229 @@
+#include "../include/BloomFilter.h"
+#include "../include/AtomicFile.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+    constexpr char FILTER_MAGIC[4] = { 'G', 'B', 'L', 'M' };
+    constexpr uint32_t FILTER_VERSION = 2; // 2: records its source
+
+    // One odd multiplier per word picks that word's bit
+    constexpr uint32_t SALTS[8] = {
+        0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+        0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u
+    };
+
+}
+
+// ==================== File management ====================
+
+bool BloomFilter::open(const std::string& path)
+{
+    close();
+
+    std::ifstream file(path, std::ios::binary);
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (file && std::memcmp(header.magic, FILTER_MAGIC, sizeof(FILTER_MAGIC)) == 0
+        && header.version == FILTER_VERSION && header.blockCount > 0
+        && header.blockCount <= UINT32_MAX) {
+        blocks.resize(static_cast<size_t>(header.blockCount));
+        file.read(reinterpret_cast<char*>(blocks.data()),
+            static_cast<std::streamsize>(blocks.size() * sizeof(Block)));
+        if (file) {
+            this->path = path;
+            return true;
+        }
+    }
+
+    close();
+    return false;
+}
+
+void BloomFilter::close()
+{
+    path.clear();
+    header = Header{};
+    blocks.clear();
+    dirty.clear();
+}
+
+// ==================== Probing ====================
+
+bool BloomFilter::mayContain(std::string_view key) const
+{
+    if (blocks.empty())
+        return true;
+
+    const uint64_t h = hash(key);
+    const Block& block = blocks[blockFor(h)];
+    const Block mask = maskFor(h);
+
+    uint64_t missing = 0;
+    for (size_t i = 0; i < 8; ++i)
+        missing |= mask.words[i] & ~block.words[i];
+
+    return missing == 0;
+}
+
+void BloomFilter::add(std::string_view key)
+{
+    if (blocks.empty())
+        return;
+
+    const uint64_t h = hash(key);
+    const size_t index = blockFor(h);
+    Block& block = blocks[index];
+    const Block mask = maskFor(h);
+
+    uint64_t missing = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        missing |= mask.words[i] & ~block.words[i];
+        block.words[i] |= mask.words[i];
+    }
+
+    // A key whose bits were all set already costs no capacity
+    if (missing != 0) {
+        ++header.keyCount;
+        dirty.push_back(index);
+    }
+}
+
+bool BloomFilter::flush()
+{
+    if (!isOpen())
+        return false;
+
+    if (dirty.empty())
+        return true;
+
+    return writeBack();
+}
+
+// ==================== Source ====================
+
+bool BloomFilter::builtFrom(const Source& source) const
+{
+    return isOpen() && source.data.exists && header.sourceRecords == source.records
+        && header.sourceIdentity == source.data.identity && header.sourceSize == source.data.size
+        && header.sourceModified == source.data.modified;
+}
+
+bool BloomFilter::setSource(const Source& source)
+{
+    if (!isOpen())
+        return false;
+
+    header.sourceRecords = source.records;
+    header.sourceIdentity = source.data.identity;
+    header.sourceSize = source.data.size;
+    header.sourceModified = source.data.modified;
+    return writeBack();
+}
+
+// ==================== Rebuild ====================
+
+bool BloomFilter::rebuild(const std::string& path, const std::vector<std::string_view>& keys, size_t capacity,
+    const Source& source)
+{
+    close();
+
+    capacity = std::max(capacity, keys.size());
+    const size_t bitsPerBlock = BLOCK_SIZE * 8;
+    const size_t blockCount = std::max<size_t>(1, (capacity * BITS_PER_KEY + bitsPerBlock - 1) / bitsPerBlock);
+
+    std::memcpy(header.magic, FILTER_MAGIC, sizeof(FILTER_MAGIC));
+    header.version = FILTER_VERSION;
+    header.blockCount = blockCount;
+    header.capacity = capacity;
+    header.sourceRecords = source.records;
+    header.sourceIdentity = source.data.identity;
+    header.sourceSize = source.data.size;
+    header.sourceModified = source.data.modified;
+    blocks.assign(blockCount, Block{});
+
+    for (std::string_view key : keys)
+        add(key);
+    dirty.clear();
+
+    // Written whole and renamed into place, so readers never see it half built
+    bool saved = AtomicFile::replace(path, {
+        std::string_view(reinterpret_cast<const char*>(&header), sizeof(header)),
+        std::string_view(reinterpret_cast<const char*>(blocks.data()), blocks.size() * sizeof(Block)) });
+
+    if (!saved) {
+        close();
+        return false;
+    }
+
+    this->path = path;
+    return true;
+}
+
+// ==================== Hashing ====================
+
+// FNV-1a, then the splitmix64 finalizer: stable across processes and
+// builds, which the file format needs
+uint64_t BloomFilter::hash(std::string_view key)
+{
+    uint64_t value = 0xcbf29ce484222325ull;
+    for (unsigned char c : key) {
+        value ^= c;
+        value *= 0x100000001b3ull;
+    }
+
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ull;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+BloomFilter::Block BloomFilter::maskFor(uint64_t hash)
+{
+    const uint32_t low = static_cast<uint32_t>(hash);
+
+    Block mask;
+    for (size_t i = 0; i < 8; ++i)
+        mask.words[i] = 1ull << ((low * SALTS[i]) >> 26);
+
+    return mask;
+}
+
+// High half of the hash scaled onto the block count, no division
+size_t BloomFilter::blockFor(uint64_t hash) const
+{
+    return static_cast<size_t>(((hash >> 32) * header.blockCount) >> 32);
+}
+
+// ==================== Helpers ====================
+
+// Dirty blocks, then the header, then a sync: the filter must be on disk
+// before the data file that relies on it
+bool BloomFilter::writeBack()
+{
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        if (!file.is_open())
+            return false;
+
+        std::sort(dirty.begin(), dirty.end());
+        dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+
+        for (size_t index : dirty) {
+            file.seekp(static_cast<std::streamoff>(sizeof(Header) + index * sizeof(Block)));
+            file.write(reinterpret_cast<const char*>(&blocks[index]), sizeof(Block));
+        }
+
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.close();
+
+        if (!file)
+            return false;
+    }
+
+    dirty.clear();
+    return AtomicFile::sync(path);
+}
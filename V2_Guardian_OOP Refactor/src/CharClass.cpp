@@ -0,0 +1,430 @@
+#include "../include/CharClass.h"
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CHARCLASS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CHARCLASS_TARGET(isa)
+#else
+#define CHARCLASS_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+// ==================== Class table ====================
+
+namespace {
+
+    constexpr uint8_t classify(int c)
+    {
+        return (c >= 'A' && c <= 'Z') ? CharClass::UPPER
+            : (c >= 'a' && c <= 'z') ? CharClass::LOWER
+            : (c >= '0' && c <= '9') ? CharClass::DIGIT
+            : (c == '_') ? CharClass::UNDERSCORE
+            : (c == '.' || c == '-') ? CharClass::DOT_DASH
+            : (c == ' ' || (c >= '\t' && c <= '\r')) ? CharClass::SPACE
+            : CharClass::OTHER;
+    }
+
+} // namespace
+
+#define CLASSIFY4(n) classify(n), classify(n + 1), classify(n + 2), classify(n + 3)
+#define CLASSIFY16(n) CLASSIFY4(n), CLASSIFY4(n + 4), CLASSIFY4(n + 8), CLASSIFY4(n + 12)
+#define CLASSIFY64(n) CLASSIFY16(n), CLASSIFY16(n + 16), CLASSIFY16(n + 32), CLASSIFY16(n + 48)
+
+const uint8_t CharClass::TABLE[256] = {
+    CLASSIFY64(0), CLASSIFY64(64), CLASSIFY64(128), CLASSIFY64(192)
+};
+
+#undef CLASSIFY64
+#undef CLASSIFY16
+#undef CLASSIFY4
+
+namespace {
+
+    // ==================== Scalar kernel ====================
+
+    size_t findFirstNotInScalar(const char* data, size_t length, uint8_t classes)
+    {
+        for (size_t i = 0; i < length; ++i) {
+            if (!(CharClass::classOf(data[i]) & classes))
+                return i;
+        }
+        return length;
+    }
+
+    uint8_t classesPresentScalar(const char* data, size_t length)
+    {
+        uint8_t present = 0;
+        for (size_t i = 0; i < length; ++i)
+            present |= CharClass::classOf(data[i]);
+        return present;
+    }
+
+#ifdef CHARCLASS_X86
+
+    inline unsigned lowestSetBit(uint32_t mask)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    // Below one vector the table walk is faster than any setup
+    const size_t SIMD_MIN_LENGTH = 16;
+
+    // Tails are copied into a padded block so a full-width load never reads
+    // past the caller's buffer. Padding repeats the first byte, which leaves
+    // classesPresent unchanged; findFirstNotIn masks it off.
+    template <size_t WIDTH>
+    struct Block {
+        alignas(WIDTH) char bytes[WIDTH];
+
+        Block(const char* data, size_t length)
+        {
+            std::memset(bytes, data[0], WIDTH);
+            std::memcpy(bytes, data, length);
+        }
+    };
+
+    // ==================== SSE4.2 kernel ====================
+
+    // PCMPESTRI range table: up to eight inclusive [lo, hi] pairs
+    struct Ranges {
+        char pairs[16] = {};
+        int length = 0;
+
+        explicit Ranges(uint8_t classes)
+        {
+            if (classes & CharClass::UPPER)      add('A', 'Z');
+            if (classes & CharClass::LOWER)      add('a', 'z');
+            if (classes & CharClass::DIGIT)      add('0', '9');
+            if (classes & CharClass::UNDERSCORE) add('_', '_');
+            if (classes & CharClass::DOT_DASH) { add('.', '.'); add('-', '-'); }
+            if (classes & CharClass::SPACE)    { add(' ', ' '); add('\t', '\r'); }
+        }
+
+        void add(char lo, char hi)
+        {
+            pairs[length++] = lo;
+            pairs[length++] = hi;
+        }
+    };
+
+    CHARCLASS_TARGET("sse4.2")
+    size_t findFirstNotInSse42(const char* data, size_t length, uint8_t classes)
+    {
+        if (length < SIMD_MIN_LENGTH)
+            return findFirstNotInScalar(data, length, classes);
+
+        const Ranges ranges(classes);
+        const __m128i table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ranges.pairs));
+        const int mode = _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES
+            | _SIDD_MASKED_NEGATIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT;
+
+        size_t i = 0;
+        for (; i + 16 <= length; i += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            int index = _mm_cmpestri(table, ranges.length, chunk, 16, mode);
+            if (index < 16)
+                return i + index;
+        }
+
+        if (i == length)
+            return length;
+
+        const Block<16> tail(data + i, length - i);
+        __m128i chunk = _mm_load_si128(reinterpret_cast<const __m128i*>(tail.bytes));
+        int index = _mm_cmpestri(table, ranges.length, chunk, static_cast<int>(length - i), mode);
+        return index < 16 ? i + index : length;
+    }
+
+    // Unsigned lo <= byte <= hi as a byte mask
+    CHARCLASS_TARGET("sse4.2")
+    inline __m128i inRange128(__m128i v, char lo, char hi)
+    {
+        __m128i offset = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+        return _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(static_cast<char>(hi - lo))), offset);
+    }
+
+    struct Masks128 {
+        __m128i upper, lower, digit, underscore, dotDash, space, other;
+    };
+
+    CHARCLASS_TARGET("sse4.2")
+    inline void accumulate128(Masks128& acc, __m128i v)
+    {
+        __m128i upper = inRange128(v, 'A', 'Z');
+        __m128i lower = inRange128(v, 'a', 'z');
+        __m128i digit = inRange128(v, '0', '9');
+        __m128i underscore = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+        __m128i dotDash = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('.')),
+            _mm_cmpeq_epi8(v, _mm_set1_epi8('-')));
+        __m128i space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+            inRange128(v, '\t', '\r'));
+
+        __m128i known = _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, underscore)),
+            _mm_or_si128(dotDash, space));
+
+        acc.upper = _mm_or_si128(acc.upper, upper);
+        acc.lower = _mm_or_si128(acc.lower, lower);
+        acc.digit = _mm_or_si128(acc.digit, digit);
+        acc.underscore = _mm_or_si128(acc.underscore, underscore);
+        acc.dotDash = _mm_or_si128(acc.dotDash, dotDash);
+        acc.space = _mm_or_si128(acc.space, space);
+        acc.other = _mm_or_si128(acc.other, _mm_andnot_si128(known, _mm_set1_epi8(-1)));
+    }
+
+    CHARCLASS_TARGET("sse4.2")
+    uint8_t classesPresentSse42(const char* data, size_t length)
+    {
+        if (length < SIMD_MIN_LENGTH)
+            return classesPresentScalar(data, length);
+
+        const __m128i zero = _mm_setzero_si128();
+        Masks128 acc = { zero, zero, zero, zero, zero, zero, zero };
+
+        size_t i = 0;
+        for (; i + 16 <= length; i += 16)
+            accumulate128(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+
+        if (i < length) {
+            const Block<16> tail(data + i, length - i);
+            accumulate128(acc, _mm_load_si128(reinterpret_cast<const __m128i*>(tail.bytes)));
+        }
+
+        uint8_t present = 0;
+        if (_mm_movemask_epi8(acc.upper))      present |= CharClass::UPPER;
+        if (_mm_movemask_epi8(acc.lower))      present |= CharClass::LOWER;
+        if (_mm_movemask_epi8(acc.digit))      present |= CharClass::DIGIT;
+        if (_mm_movemask_epi8(acc.underscore)) present |= CharClass::UNDERSCORE;
+        if (_mm_movemask_epi8(acc.dotDash))    present |= CharClass::DOT_DASH;
+        if (_mm_movemask_epi8(acc.space))      present |= CharClass::SPACE;
+        if (_mm_movemask_epi8(acc.other))      present |= CharClass::OTHER;
+        return present;
+    }
+
+    // ==================== AVX2 kernel ====================
+
+    CHARCLASS_TARGET("avx2")
+    inline __m256i inRange256(__m256i v, char lo, char hi)
+    {
+        __m256i offset = _mm256_sub_epi8(v, _mm256_set1_epi8(lo));
+        return _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8(static_cast<char>(hi - lo))), offset);
+    }
+
+    CHARCLASS_TARGET("avx2")
+    inline __m256i matchClasses256(__m256i v, uint8_t classes)
+    {
+        __m256i match = _mm256_setzero_si256();
+
+        if (classes & CharClass::UPPER)
+            match = _mm256_or_si256(match, inRange256(v, 'A', 'Z'));
+        if (classes & CharClass::LOWER)
+            match = _mm256_or_si256(match, inRange256(v, 'a', 'z'));
+        if (classes & CharClass::DIGIT)
+            match = _mm256_or_si256(match, inRange256(v, '0', '9'));
+        if (classes & CharClass::UNDERSCORE)
+            match = _mm256_or_si256(match, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+        if (classes & CharClass::DOT_DASH) {
+            match = _mm256_or_si256(match, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('.')));
+            match = _mm256_or_si256(match, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('-')));
+        }
+        if (classes & CharClass::SPACE) {
+            match = _mm256_or_si256(match, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')));
+            match = _mm256_or_si256(match, inRange256(v, '\t', '\r'));
+        }
+
+        return match;
+    }
+
+    CHARCLASS_TARGET("avx2")
+    size_t findFirstNotInAvx2(const char* data, size_t length, uint8_t classes)
+    {
+        if (length < SIMD_MIN_LENGTH)
+            return findFirstNotInScalar(data, length, classes);
+
+        size_t i = 0;
+        for (; i + 32 <= length; i += 32) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            uint32_t invalid = ~static_cast<uint32_t>(_mm256_movemask_epi8(matchClasses256(chunk, classes)));
+            if (invalid)
+                return i + lowestSetBit(invalid);
+        }
+
+        if (i == length)
+            return length;
+
+        const size_t remaining = length - i;
+        const Block<32> tail(data + i, remaining);
+        __m256i chunk = _mm256_load_si256(reinterpret_cast<const __m256i*>(tail.bytes));
+        uint32_t invalid = ~static_cast<uint32_t>(_mm256_movemask_epi8(matchClasses256(chunk, classes)))
+            & ((1u << remaining) - 1);
+
+        return invalid ? i + lowestSetBit(invalid) : length;
+    }
+
+    struct Masks256 {
+        __m256i upper, lower, digit, underscore, dotDash, space, other;
+    };
+
+    CHARCLASS_TARGET("avx2")
+    inline void accumulate256(Masks256& acc, __m256i v)
+    {
+        __m256i upper = inRange256(v, 'A', 'Z');
+        __m256i lower = inRange256(v, 'a', 'z');
+        __m256i digit = inRange256(v, '0', '9');
+        __m256i underscore = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'));
+        __m256i dotDash = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('.')),
+            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('-')));
+        __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+            inRange256(v, '\t', '\r'));
+
+        __m256i known = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(upper, lower),
+            _mm256_or_si256(digit, underscore)), _mm256_or_si256(dotDash, space));
+
+        acc.upper = _mm256_or_si256(acc.upper, upper);
+        acc.lower = _mm256_or_si256(acc.lower, lower);
+        acc.digit = _mm256_or_si256(acc.digit, digit);
+        acc.underscore = _mm256_or_si256(acc.underscore, underscore);
+        acc.dotDash = _mm256_or_si256(acc.dotDash, dotDash);
+        acc.space = _mm256_or_si256(acc.space, space);
+        acc.other = _mm256_or_si256(acc.other, _mm256_andnot_si256(known, _mm256_set1_epi8(-1)));
+    }
+
+    CHARCLASS_TARGET("avx2")
+    uint8_t classesPresentAvx2(const char* data, size_t length)
+    {
+        if (length < SIMD_MIN_LENGTH)
+            return classesPresentScalar(data, length);
+
+        const __m256i zero = _mm256_setzero_si256();
+        Masks256 acc = { zero, zero, zero, zero, zero, zero, zero };
+
+        size_t i = 0;
+        for (; i + 32 <= length; i += 32)
+            accumulate256(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+
+        if (i < length) {
+            const Block<32> tail(data + i, length - i);
+            accumulate256(acc, _mm256_load_si256(reinterpret_cast<const __m256i*>(tail.bytes)));
+        }
+
+        uint8_t present = 0;
+        if (_mm256_movemask_epi8(acc.upper))      present |= CharClass::UPPER;
+        if (_mm256_movemask_epi8(acc.lower))      present |= CharClass::LOWER;
+        if (_mm256_movemask_epi8(acc.digit))      present |= CharClass::DIGIT;
+        if (_mm256_movemask_epi8(acc.underscore)) present |= CharClass::UNDERSCORE;
+        if (_mm256_movemask_epi8(acc.dotDash))    present |= CharClass::DOT_DASH;
+        if (_mm256_movemask_epi8(acc.space))      present |= CharClass::SPACE;
+        if (_mm256_movemask_epi8(acc.other))      present |= CharClass::OTHER;
+        return present;
+    }
+
+    // ==================== CPU detection ====================
+
+    bool cpuHasSse42()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 20)) != 0;
+#else
+        return __builtin_cpu_supports("sse4.2");
+#endif
+    }
+
+    bool cpuHasAvx2()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        // The OS must also save the YMM registers on context switch
+        __cpuid(info, 1);
+        bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+
+        __cpuidex(info, 7, 0);
+        return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+#endif // CHARCLASS_X86
+
+    // ==================== Dispatch ====================
+
+    struct KernelTable {
+        CharClass::Kernel kernel;
+        size_t (*findFirstNotIn)(const char*, size_t, uint8_t);
+        uint8_t (*classesPresent)(const char*, size_t);
+    };
+
+    const KernelTable SCALAR_KERNEL = { CharClass::SCALAR, findFirstNotInScalar, classesPresentScalar };
+#ifdef CHARCLASS_X86
+    const KernelTable SSE42_KERNEL = { CharClass::SSE42, findFirstNotInSse42, classesPresentSse42 };
+    const KernelTable AVX2_KERNEL = { CharClass::AVX2, findFirstNotInAvx2, classesPresentAvx2 };
+#endif
+
+    const KernelTable* kernelFor(CharClass::Kernel kernel)
+    {
+#ifdef CHARCLASS_X86
+        if (kernel == CharClass::AVX2)
+            return &AVX2_KERNEL;
+        if (kernel == CharClass::SSE42)
+            return &SSE42_KERNEL;
+#endif
+        return &SCALAR_KERNEL;
+    }
+
+    std::atomic<const KernelTable*>& selectedKernel()
+    {
+        static std::atomic<const KernelTable*> selected(kernelFor(CharClass::bestSupportedKernel()));
+        return selected;
+    }
+
+} // namespace
+
+// ==================== Primitives ====================
+
+size_t CharClass::findFirstNotIn(const char* data, size_t length, uint8_t classes)
+{
+    return selectedKernel().load(std::memory_order_relaxed)->findFirstNotIn(data, length, classes);
+}
+
+uint8_t CharClass::classesPresent(const char* data, size_t length)
+{
+    return selectedKernel().load(std::memory_order_relaxed)->classesPresent(data, length);
+}
+
+// ==================== Kernel selection ====================
+
+CharClass::Kernel CharClass::activeKernel()
+{
+    return selectedKernel().load()->kernel;
+}
+
+CharClass::Kernel CharClass::bestSupportedKernel()
+{
+#ifdef CHARCLASS_X86
+    static const Kernel best = cpuHasAvx2() ? AVX2 : cpuHasSse42() ? SSE42 : SCALAR;
+    return best;
+#else
+    return SCALAR;
+#endif
+}
+
+void CharClass::setKernel(Kernel kernel)
+{
+    Kernel best = bestSupportedKernel();
+    selectedKernel().store(kernelFor(kernel <= best ? kernel : best));
+}
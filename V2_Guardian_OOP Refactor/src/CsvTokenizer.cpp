@@ -0,0 +1,101 @@
+#include "../include/CsvTokenizer.h"
+#include <cstring>
+
+// ==================== Tokenizing ====================
+
+bool CsvTokenizer::tokenize(std::string_view line)
+{
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+
+    // Rows written before quoting existed were joined with bare commas, so
+    // a field of theirs may start with a quote and fail the quoted parse.
+    // Such a row is read the old way rather than dropped.
+    return split(line, true) || split(line, false);
+}
+
+bool CsvTokenizer::split(std::string_view line, bool quoting)
+{
+    count = 0;
+    unescaped.clear();
+
+    size_t pos = 0;
+
+    while (true) {
+        if (count == MAX_FIELDS)
+            return false;
+
+        if (quoting && pos < line.size() && line[pos] == '"') {
+            if (!tokenizeQuoted(line, pos))
+                return false;
+        }
+        else {
+            const void* comma = std::memchr(line.data() + pos, ',', line.size() - pos);
+            size_t end = comma ? static_cast<const char*>(comma) - line.data() : line.size();
+
+            fields[count++] = line.substr(pos, end - pos);
+            pos = end;
+        }
+
+        // pos is now on a comma or at the end of the line
+        if (pos >= line.size())
+            return true;
+
+        ++pos;
+    }
+}
+
+bool CsvTokenizer::tokenizeQuoted(std::string_view line, size_t& pos)
+{
+    // Unescaped text is never longer than the line, so reserving that much
+    // up front keeps earlier views into the buffer valid
+    if (unescaped.capacity() < line.size())
+        unescaped.reserve(line.size());
+
+    const size_t start = unescaped.size();
+    ++pos; // opening quote
+
+    while (true) {
+        const void* quote = std::memchr(line.data() + pos, '"', line.size() - pos);
+        if (!quote)
+            return false;
+
+        size_t at = static_cast<const char*>(quote) - line.data();
+        unescaped.append(line.data() + pos, at - pos);
+        pos = at + 1;
+
+        // A doubled quote is a literal quote; anything else ends the field
+        if (pos < line.size() && line[pos] == '"') {
+            unescaped.push_back('"');
+            ++pos;
+            continue;
+        }
+
+        if (pos < line.size() && line[pos] != ',')
+            return false;
+
+        fields[count++] = std::string_view(unescaped).substr(start);
+        return true;
+    }
+}
+
+// ==================== Writing ====================
+
+void CsvTokenizer::appendField(std::string& out, std::string_view field)
+{
+    bool plain = !std::memchr(field.data(), ',', field.size())
+        && !std::memchr(field.data(), '"', field.size());
+
+    if (plain) {
+        out.append(field.data(), field.size());
+        return;
+    }
+
+    out.push_back('"');
+    for (char c : field) {
+        if (c == '"')
+            out.push_back('"');
+        out.push_back(c);
+    }
+    out.push_back('"');
+}
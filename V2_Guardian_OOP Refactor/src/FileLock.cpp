@@ -0,0 +1,101 @@
+#include "../include/FileLock.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+// ==================== Constructor / Destructor ====================
+
+FileLock::FileLock(const std::string& path)
+{
+    open(path);
+}
+
+FileLock::~FileLock()
+{
+    close();
+}
+
+// ==================== File management ====================
+
+bool FileLock::open(const std::string& path)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+        OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    handle = file == INVALID_HANDLE_VALUE ? nullptr : file;
+#else
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+#endif
+
+    return isOpen();
+}
+
+// Closing drops any lock still held
+void FileLock::close()
+{
+#ifdef _WIN32
+    if (handle)
+        CloseHandle(handle);
+    handle = nullptr;
+#else
+    if (fd >= 0)
+        ::close(fd);
+    fd = -1;
+#endif
+}
+
+bool FileLock::isOpen() const
+{
+#ifdef _WIN32
+    return handle != nullptr;
+#else
+    return fd >= 0;
+#endif
+}
+
+// ==================== Locking ====================
+
+void FileLock::lock() { acquire(true, true); }
+void FileLock::unlock() { release(); }
+void FileLock::lock_shared() { acquire(false, true); }
+void FileLock::unlock_shared() { release(); }
+bool FileLock::try_lock() { return acquire(true, false); }
+
+bool FileLock::acquire(bool exclusive, bool wait)
+{
+    if (!isOpen())
+        return false;
+
+#ifdef _WIN32
+    OVERLAPPED whole = {};
+    DWORD flags = (exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0) | (wait ? 0 : LOCKFILE_FAIL_IMMEDIATELY);
+    return LockFileEx(handle, flags, 0, MAXDWORD, MAXDWORD, &whole) != 0;
+#else
+    int operation = (exclusive ? LOCK_EX : LOCK_SH) | (wait ? 0 : LOCK_NB);
+    int result;
+    while ((result = flock(fd, operation)) != 0 && errno == EINTR) {}
+    return result == 0;
+#endif
+}
+
+void FileLock::release()
+{
+    if (!isOpen())
+        return;
+
+#ifdef _WIN32
+    OVERLAPPED whole = {};
+    UnlockFileEx(handle, 0, MAXDWORD, MAXDWORD, &whole);
+#else
+    flock(fd, LOCK_UN);
+#endif
+}
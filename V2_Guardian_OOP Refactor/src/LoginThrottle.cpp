@@ -0,0 +1,179 @@
+#include "../include/LoginThrottle.h"
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <thread>
+
+namespace {
+
+    const uint64_t ONE_TOKEN = 1u << 16;     // cells count tokens in 16.16 fixed point
+    const double TICKS_PER_SECOND = 16;
+
+    // Bits of a cell: tick of the last update, then tokens short of full.
+    // A zeroed cell is a full bucket.
+    uint64_t packCell(uint32_t tick, uint32_t shortfall)
+    {
+        return (static_cast<uint64_t>(tick) << 32) | shortfall;
+    }
+
+    uint64_t mix(uint64_t value)
+    {
+        // splitmix64 finalizer
+        value ^= value >> 30;
+        value *= 0xbf58476d1ce4e5b9ull;
+        value ^= value >> 27;
+        value *= 0x94d049bb133111ebull;
+        return value ^ (value >> 31);
+    }
+
+}
+
+// ==================== Constructor ====================
+
+LoginThrottle::LoginThrottle(LoginThrottleOptions options)
+    : start(std::chrono::steady_clock::now()),
+      seed((static_cast<uint64_t>(std::random_device()()) << 32) | std::random_device()()),
+      usernames(std::make_unique<Table>()),
+      sources(std::make_unique<Table>()),
+      stripes(std::make_unique<Counters[]>(COUNTER_STRIPES))
+{
+    configure(*usernames, options.usernameBurst, options.usernameRatePerSecond);
+    configure(*sources, options.sourceBurst, options.sourceRatePerSecond);
+}
+
+void LoginThrottle::configure(Table& table, double burst, double ratePerSecond)
+{
+    // At least one attempt always gets through a full bucket
+    const double maxTokens = double(UINT32_MAX / ONE_TOKEN);
+    table.burst = static_cast<uint32_t>(std::clamp(burst, 1.0, maxTokens) * ONE_TOKEN);
+    table.refill = static_cast<uint32_t>(std::clamp(ratePerSecond / TICKS_PER_SECOND, 0.0, maxTokens) * ONE_TOKEN);
+}
+
+// ==================== Admission ====================
+
+LoginThrottle::Verdict LoginThrottle::admit(std::string_view username, std::string_view source)
+{
+    const uint32_t tick = now();
+
+    if (!source.empty() && exhausted(*sources, slotsFor(source), tick)) {
+        counters().rejectedSource.fetch_add(1, std::memory_order_relaxed);
+        return Verdict::REJECT_SOURCE;
+    }
+
+    if (exhausted(*usernames, slotsFor(username), tick)) {
+        counters().rejectedUsername.fetch_add(1, std::memory_order_relaxed);
+        return Verdict::REJECT_USERNAME;
+    }
+
+    counters().admitted.fetch_add(1, std::memory_order_relaxed);
+    return Verdict::ALLOW;
+}
+
+bool LoginThrottle::throttled(std::string_view username, std::string_view source) const
+{
+    const uint32_t tick = now();
+
+    return (!source.empty() && exhausted(*sources, slotsFor(source), tick))
+        || exhausted(*usernames, slotsFor(username), tick);
+}
+
+void LoginThrottle::recordFailure(std::string_view username, std::string_view source)
+{
+    const uint32_t tick = now();
+
+    if (!source.empty())
+        charge(*sources, slotsFor(source), tick);
+    charge(*usernames, slotsFor(username), tick);
+
+    counters().failures.fetch_add(1, std::memory_order_relaxed);
+}
+
+LoginThrottle::Metrics LoginThrottle::metrics() const
+{
+    Metrics result;
+
+    for (size_t i = 0; i < COUNTER_STRIPES; ++i) {
+        const Counters& stripe = stripes[i];
+        result.admitted += stripe.admitted.load(std::memory_order_relaxed);
+        result.rejectedUsername += stripe.rejectedUsername.load(std::memory_order_relaxed);
+        result.rejectedSource += stripe.rejectedSource.load(std::memory_order_relaxed);
+        result.failures += stripe.failures.load(std::memory_order_relaxed);
+    }
+
+    return result;
+}
+
+LoginThrottle::Counters& LoginThrottle::counters()
+{
+    static thread_local const size_t stripe =
+        std::hash<std::thread::id>()(std::this_thread::get_id()) % COUNTER_STRIPES;
+    return stripes[stripe];
+}
+
+// ==================== Buckets ====================
+
+// Double hashing: one 64-bit hash gives every row its own column
+LoginThrottle::Slots LoginThrottle::slotsFor(std::string_view key) const
+{
+    const uint64_t hash = mix(std::hash<std::string_view>()(key) ^ seed);
+    const uint64_t step = (hash >> 32) | 1;
+
+    Slots slots;
+    for (size_t row = 0; row < ROWS; ++row)
+        slots.column[row] = static_cast<size_t>((hash + row * step) & (COLUMNS - 1));
+
+    return slots;
+}
+
+uint32_t LoginThrottle::now() const
+{
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<uint32_t>(static_cast<uint64_t>(elapsed.count() * TICKS_PER_SECOND));
+}
+
+// How many tokens the bucket is short at tick, after refilling
+uint32_t LoginThrottle::shortfall(const Table& table, uint64_t cell, uint32_t tick)
+{
+    const uint32_t missing = static_cast<uint32_t>(cell);
+    if (missing == 0)
+        return 0;
+
+    // Another thread may have stored a later tick since ours was taken;
+    // ticks compare modulo 2^32, good for four years of idling
+    const int32_t elapsed = static_cast<int32_t>(tick - static_cast<uint32_t>(cell >> 32));
+    if (elapsed <= 0)
+        return missing;
+
+    const uint64_t refilled = static_cast<uint64_t>(elapsed) * table.refill;
+    return refilled >= missing ? 0 : static_cast<uint32_t>(missing - refilled);
+}
+
+// Throttled when no row has a whole token left; the fullest row is the
+// least collided one, as in a count-min sketch
+bool LoginThrottle::exhausted(const Table& table, const Slots& slots, uint32_t tick)
+{
+    for (size_t row = 0; row < ROWS; ++row) {
+        uint64_t cell = table.cells[row][slots.column[row]].load(std::memory_order_relaxed);
+        if (shortfall(table, cell, tick) + ONE_TOKEN <= table.burst)
+            return false;
+    }
+
+    return true;
+}
+
+void LoginThrottle::charge(Table& table, const Slots& slots, uint32_t tick)
+{
+    for (size_t row = 0; row < ROWS; ++row) {
+        std::atomic<uint64_t>& cell = table.cells[row][slots.column[row]];
+        uint64_t current = cell.load(std::memory_order_relaxed);
+        uint64_t next;
+
+        // Capped at empty, so waiting 1/rate seconds always buys a try
+        do {
+            const uint32_t last = static_cast<uint32_t>(current >> 32);
+            const uint32_t stamped = static_cast<int32_t>(tick - last) > 0 ? tick : last;
+            const uint64_t missing = std::min<uint64_t>(table.burst, shortfall(table, current, tick) + ONE_TOKEN);
+            next = packCell(stamped, static_cast<uint32_t>(missing));
+        } while (!cell.compare_exchange_weak(current, next, std::memory_order_relaxed));
+    }
+}
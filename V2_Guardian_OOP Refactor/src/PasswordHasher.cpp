@@ -0,0 +1,961 @@
+#include "../include/PasswordHasher.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ARGON2_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define ARGON2_TARGET(isa)
+#else
+#define ARGON2_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+namespace {
+
+    // ==================== BLAKE2b ====================
+
+    constexpr uint64_t BLAKE2B_IV[8] = {
+        0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+        0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+    };
+
+    constexpr uint8_t BLAKE2B_SIGMA[12][16] = {
+        { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+        { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 },
+        { 11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4 },
+        { 7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8 },
+        { 9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13 },
+        { 2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9 },
+        { 12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11 },
+        { 13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10 },
+        { 6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5 },
+        { 10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0 },
+        { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+        { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 }
+    };
+
+    inline uint64_t rotr64(uint64_t x, unsigned n)
+    {
+        return (x >> n) | (x << (64 - n));
+    }
+
+    inline uint64_t load64(const uint8_t* p)
+    {
+        uint64_t v = 0;
+        for (int i = 7; i >= 0; --i)
+            v = (v << 8) | p[i];
+        return v;
+    }
+
+    inline void store64(uint8_t* p, uint64_t v)
+    {
+        for (int i = 0; i < 8; ++i)
+            p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+
+    inline void store32(uint8_t* p, uint32_t v)
+    {
+        for (int i = 0; i < 4; ++i)
+            p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+
+    class Blake2b {
+    public:
+        explicit Blake2b(size_t outLength) : outLength(outLength)
+        {
+            std::copy(BLAKE2B_IV, BLAKE2B_IV + 8, h);
+            h[0] ^= 0x01010000ULL ^ outLength;
+        }
+
+        void update(const void* data, size_t length)
+        {
+            const uint8_t* in = static_cast<const uint8_t*>(data);
+
+            while (length > 0) {
+                // Keep the last block buffered: it must be compressed as final
+                if (bufferLength == sizeof(buffer)) {
+                    counter += sizeof(buffer);
+                    compress(false);
+                    bufferLength = 0;
+                }
+
+                size_t take = std::min(length, sizeof(buffer) - bufferLength);
+                std::memcpy(buffer + bufferLength, in, take);
+                bufferLength += take;
+                in += take;
+                length -= take;
+            }
+        }
+
+        void updateLE32(uint32_t value)
+        {
+            uint8_t bytes[4];
+            store32(bytes, value);
+            update(bytes, sizeof(bytes));
+        }
+
+        void final(uint8_t* out)
+        {
+            counter += bufferLength;
+            std::memset(buffer + bufferLength, 0, sizeof(buffer) - bufferLength);
+            compress(true);
+
+            uint8_t full[64];
+            for (int i = 0; i < 8; ++i)
+                store64(full + 8 * i, h[i]);
+            std::memcpy(out, full, outLength);
+        }
+
+    private:
+        void compress(bool last)
+        {
+            uint64_t m[16];
+            uint64_t v[16];
+
+            for (int i = 0; i < 16; ++i)
+                m[i] = load64(buffer + 8 * i);
+
+            for (int i = 0; i < 8; ++i) {
+                v[i] = h[i];
+                v[i + 8] = BLAKE2B_IV[i];
+            }
+
+            v[12] ^= counter;
+            if (last)
+                v[14] = ~v[14];
+
+            auto g = [&](int a, int b, int c, int d, uint64_t x, uint64_t y) {
+                v[a] = v[a] + v[b] + x; v[d] = rotr64(v[d] ^ v[a], 32);
+                v[c] = v[c] + v[d];     v[b] = rotr64(v[b] ^ v[c], 24);
+                v[a] = v[a] + v[b] + y; v[d] = rotr64(v[d] ^ v[a], 16);
+                v[c] = v[c] + v[d];     v[b] = rotr64(v[b] ^ v[c], 63);
+            };
+
+            for (int r = 0; r < 12; ++r) {
+                const uint8_t* s = BLAKE2B_SIGMA[r];
+                g(0, 4, 8, 12, m[s[0]], m[s[1]]);
+                g(1, 5, 9, 13, m[s[2]], m[s[3]]);
+                g(2, 6, 10, 14, m[s[4]], m[s[5]]);
+                g(3, 7, 11, 15, m[s[6]], m[s[7]]);
+                g(0, 5, 10, 15, m[s[8]], m[s[9]]);
+                g(1, 6, 11, 12, m[s[10]], m[s[11]]);
+                g(2, 7, 8, 13, m[s[12]], m[s[13]]);
+                g(3, 4, 9, 14, m[s[14]], m[s[15]]);
+            }
+
+            for (int i = 0; i < 8; ++i)
+                h[i] ^= v[i] ^ v[i + 8];
+        }
+
+        uint64_t h[8];
+        uint8_t buffer[128] = {};
+        size_t bufferLength = 0;
+        uint64_t counter = 0; // inputs never reach 2^64 bytes here
+        size_t outLength;
+    };
+
+    // Variable-length hash H' from RFC 9106 section 3.3
+    void hashLong(uint8_t* out, size_t outLength, const uint8_t* in, size_t inLength)
+    {
+        if (outLength <= 64) {
+            Blake2b h(outLength);
+            h.updateLE32(static_cast<uint32_t>(outLength));
+            h.update(in, inLength);
+            h.final(out);
+            return;
+        }
+
+        uint8_t v[64];
+        Blake2b first(64);
+        first.updateLE32(static_cast<uint32_t>(outLength));
+        first.update(in, inLength);
+        first.final(v);
+
+        std::memcpy(out, v, 32);
+        out += 32;
+        size_t remaining = outLength - 32;
+
+        while (remaining > 64) {
+            Blake2b next(64);
+            next.update(v, 64);
+            next.final(v);
+            std::memcpy(out, v, 32);
+            out += 32;
+            remaining -= 32;
+        }
+
+        Blake2b last(remaining);
+        last.update(v, 64);
+        last.final(out);
+    }
+
+    // ==================== Argon2 core ====================
+
+    constexpr uint32_t ARGON2_VERSION = 0x13;
+    constexpr uint32_t ARGON2_TYPE_ID = 2;   // Argon2id
+    constexpr uint32_t SYNC_POINTS = 4;
+    constexpr size_t QWORDS_IN_BLOCK = 128;  // 1 KiB blocks
+
+    struct Block {
+        uint64_t v[QWORDS_IN_BLOCK];
+    };
+
+    // BlaMka: Blake2b's G with an added 2 * lo32(a) * lo32(b) term
+    inline uint64_t blamka(uint64_t x, uint64_t y)
+    {
+        const uint64_t mask = 0xFFFFFFFFULL;
+        return x + y + 2 * ((x & mask) * (y & mask));
+    }
+
+    inline void gb(uint64_t& a, uint64_t& b, uint64_t& c, uint64_t& d)
+    {
+        a = blamka(a, b); d = rotr64(d ^ a, 32);
+        c = blamka(c, d); b = rotr64(b ^ c, 24);
+        a = blamka(a, b); d = rotr64(d ^ a, 16);
+        c = blamka(c, d); b = rotr64(b ^ c, 63);
+    }
+
+    inline void permute(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3,
+        uint64_t& v4, uint64_t& v5, uint64_t& v6, uint64_t& v7,
+        uint64_t& v8, uint64_t& v9, uint64_t& v10, uint64_t& v11,
+        uint64_t& v12, uint64_t& v13, uint64_t& v14, uint64_t& v15)
+    {
+        gb(v0, v4, v8, v12);
+        gb(v1, v5, v9, v13);
+        gb(v2, v6, v10, v14);
+        gb(v3, v7, v11, v15);
+        gb(v0, v5, v10, v15);
+        gb(v1, v6, v11, v12);
+        gb(v2, v7, v8, v13);
+        gb(v3, v4, v9, v14);
+    }
+
+    // ==================== Scalar kernel ====================
+
+    // next = G(prev, ref) (XOR next when overwriting on later passes)
+    void fillBlockScalar(const Block& prev, const Block& ref, Block& next, bool withXor)
+    {
+        Block r;
+        Block tmp;
+
+        for (size_t i = 0; i < QWORDS_IN_BLOCK; ++i)
+            r.v[i] = prev.v[i] ^ ref.v[i];
+
+        tmp = r;
+        if (withXor) {
+            for (size_t i = 0; i < QWORDS_IN_BLOCK; ++i)
+                tmp.v[i] ^= next.v[i];
+        }
+
+        uint64_t* v = r.v;
+
+        // Rows: 8 groups of 16 consecutive words
+        for (size_t i = 0; i < 8; ++i) {
+            uint64_t* w = v + 16 * i;
+            permute(w[0], w[1], w[2], w[3], w[4], w[5], w[6], w[7],
+                w[8], w[9], w[10], w[11], w[12], w[13], w[14], w[15]);
+        }
+
+        // Columns: 8 groups of 16 words, two per row
+        for (size_t i = 0; i < 8; ++i) {
+            uint64_t* w = v + 2 * i;
+            permute(w[0], w[1], w[16], w[17], w[32], w[33], w[48], w[49],
+                w[64], w[65], w[80], w[81], w[96], w[97], w[112], w[113]);
+        }
+
+        for (size_t i = 0; i < QWORDS_IN_BLOCK; ++i)
+            next.v[i] = tmp.v[i] ^ r.v[i];
+    }
+
+#ifdef ARGON2_X86
+
+    // Both vector kernels run the same permutation as the scalar one on
+    // four registers A, B, C, D of consecutive words: G on the columns,
+    // rotate B, C and D so the diagonals line up, G again, rotate back.
+    // Every kernel reads all its inputs before writing next, which may be
+    // the same block as ref.
+
+    // ==================== SSE2 kernel ====================
+
+    // A register holds two words, so A, B, C and D are each a pair
+    struct Sse2Row {
+        __m128i a0, a1, b0, b1, c0, c1, d0, d1;
+    };
+
+    template <int N>
+    ARGON2_TARGET("sse2")
+    inline __m128i rotrSse2(__m128i x)
+    {
+        if constexpr (N == 32)
+            return _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1));
+        else
+            return _mm_xor_si128(_mm_srli_epi64(x, N), _mm_slli_epi64(x, 64 - N));
+    }
+
+    ARGON2_TARGET("sse2")
+    inline __m128i blamkaSse2(__m128i x, __m128i y)
+    {
+        const __m128i product = _mm_mul_epu32(x, y);
+        return _mm_add_epi64(_mm_add_epi64(x, y), _mm_add_epi64(product, product));
+    }
+
+    ARGON2_TARGET("sse2")
+    inline void gbSse2(__m128i& a, __m128i& b, __m128i& c, __m128i& d)
+    {
+        a = blamkaSse2(a, b); d = rotrSse2<32>(_mm_xor_si128(d, a));
+        c = blamkaSse2(c, d); b = rotrSse2<24>(_mm_xor_si128(b, c));
+        a = blamkaSse2(a, b); d = rotrSse2<16>(_mm_xor_si128(d, a));
+        c = blamkaSse2(c, d); b = rotrSse2<63>(_mm_xor_si128(b, c));
+    }
+
+    ARGON2_TARGET("sse2")
+    inline void permuteSse2(Sse2Row& r)
+    {
+        gbSse2(r.a0, r.b0, r.c0, r.d0);
+        gbSse2(r.a1, r.b1, r.c1, r.d1);
+
+        // B left by one word, C by two, D by three
+        __m128i b0 = r.b0, c0 = r.c0, d0 = r.d0;
+        r.b0 = _mm_unpackhi_epi64(b0, _mm_unpacklo_epi64(r.b1, r.b1));
+        r.b1 = _mm_unpackhi_epi64(r.b1, _mm_unpacklo_epi64(b0, b0));
+        r.c0 = r.c1; r.c1 = c0;
+        r.d0 = _mm_unpackhi_epi64(r.d1, _mm_unpacklo_epi64(d0, d0));
+        r.d1 = _mm_unpackhi_epi64(d0, _mm_unpacklo_epi64(r.d1, r.d1));
+
+        gbSse2(r.a0, r.b0, r.c0, r.d0);
+        gbSse2(r.a1, r.b1, r.c1, r.d1);
+
+        b0 = r.b0; c0 = r.c0; d0 = r.d0;
+        r.b0 = _mm_unpackhi_epi64(r.b1, _mm_unpacklo_epi64(b0, b0));
+        r.b1 = _mm_unpackhi_epi64(b0, _mm_unpacklo_epi64(r.b1, r.b1));
+        r.c0 = r.c1; r.c1 = c0;
+        r.d0 = _mm_unpackhi_epi64(d0, _mm_unpacklo_epi64(r.d1, r.d1));
+        r.d1 = _mm_unpackhi_epi64(r.d1, _mm_unpacklo_epi64(d0, d0));
+    }
+
+    ARGON2_TARGET("sse2")
+    void fillBlockSse2(const Block& prev, const Block& ref, Block& next, bool withXor)
+    {
+        constexpr size_t REGISTERS = QWORDS_IN_BLOCK / 2;
+        __m128i r[REGISTERS];
+        __m128i tmp[REGISTERS];
+
+        for (size_t i = 0; i < REGISTERS; ++i) {
+            r[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(prev.v + 2 * i)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ref.v + 2 * i)));
+            tmp[i] = withXor
+                ? _mm_xor_si128(r[i], _mm_loadu_si128(reinterpret_cast<const __m128i*>(next.v + 2 * i)))
+                : r[i];
+        }
+
+        // Rows: registers 8i .. 8i + 7
+        for (size_t i = 0; i < 8; ++i) {
+            Sse2Row row{ r[8 * i], r[8 * i + 1], r[8 * i + 2], r[8 * i + 3],
+                r[8 * i + 4], r[8 * i + 5], r[8 * i + 6], r[8 * i + 7] };
+            permuteSse2(row);
+            r[8 * i] = row.a0; r[8 * i + 1] = row.a1; r[8 * i + 2] = row.b0; r[8 * i + 3] = row.b1;
+            r[8 * i + 4] = row.c0; r[8 * i + 5] = row.c1; r[8 * i + 6] = row.d0; r[8 * i + 7] = row.d1;
+        }
+
+        // Columns: register i of every row
+        for (size_t i = 0; i < 8; ++i) {
+            Sse2Row column{ r[i], r[8 + i], r[16 + i], r[24 + i],
+                r[32 + i], r[40 + i], r[48 + i], r[56 + i] };
+            permuteSse2(column);
+            r[i] = column.a0; r[8 + i] = column.a1; r[16 + i] = column.b0; r[24 + i] = column.b1;
+            r[32 + i] = column.c0; r[40 + i] = column.c1; r[48 + i] = column.d0; r[56 + i] = column.d1;
+        }
+
+        for (size_t i = 0; i < REGISTERS; ++i)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(next.v + 2 * i), _mm_xor_si128(tmp[i], r[i]));
+    }
+
+    // ==================== AVX2 kernel ====================
+
+    // Rotations by whole bytes are byte shuffles
+    template <int N>
+    ARGON2_TARGET("avx2")
+    inline __m256i rotrAvx2(__m256i x)
+    {
+        if constexpr (N == 32) {
+            return _mm256_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1));
+        }
+        else if constexpr (N == 24) {
+            return _mm256_shuffle_epi8(x, _mm256_setr_epi8(
+                3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,
+                3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10));
+        }
+        else if constexpr (N == 16) {
+            return _mm256_shuffle_epi8(x, _mm256_setr_epi8(
+                2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,
+                2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9));
+        }
+        else {
+            return _mm256_xor_si256(_mm256_srli_epi64(x, N), _mm256_slli_epi64(x, 64 - N));
+        }
+    }
+
+    ARGON2_TARGET("avx2")
+    inline __m256i blamkaAvx2(__m256i x, __m256i y)
+    {
+        const __m256i product = _mm256_mul_epu32(x, y);
+        return _mm256_add_epi64(_mm256_add_epi64(x, y), _mm256_add_epi64(product, product));
+    }
+
+    ARGON2_TARGET("avx2")
+    inline void gbAvx2(__m256i& a, __m256i& b, __m256i& c, __m256i& d)
+    {
+        a = blamkaAvx2(a, b); d = rotrAvx2<32>(_mm256_xor_si256(d, a));
+        c = blamkaAvx2(c, d); b = rotrAvx2<24>(_mm256_xor_si256(b, c));
+        a = blamkaAvx2(a, b); d = rotrAvx2<16>(_mm256_xor_si256(d, a));
+        c = blamkaAvx2(c, d); b = rotrAvx2<63>(_mm256_xor_si256(b, c));
+    }
+
+    // A register holds four words, so A, B, C and D are one each
+    ARGON2_TARGET("avx2")
+    inline void permuteAvx2(__m256i& a, __m256i& b, __m256i& c, __m256i& d)
+    {
+        gbAvx2(a, b, c, d);
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));
+        c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(2, 1, 0, 3));
+
+        gbAvx2(a, b, c, d);
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));
+        c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(0, 3, 2, 1));
+    }
+
+    ARGON2_TARGET("avx2")
+    void fillBlockAvx2(const Block& prev, const Block& ref, Block& next, bool withXor)
+    {
+        constexpr size_t REGISTERS = QWORDS_IN_BLOCK / 4;
+        __m256i r[REGISTERS];
+        __m256i tmp[REGISTERS];
+
+        for (size_t i = 0; i < REGISTERS; ++i) {
+            r[i] = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev.v + 4 * i)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ref.v + 4 * i)));
+            tmp[i] = withXor
+                ? _mm256_xor_si256(r[i], _mm256_loadu_si256(reinterpret_cast<const __m256i*>(next.v + 4 * i)))
+                : r[i];
+        }
+
+        // Rows: registers 4i .. 4i + 3
+        for (size_t i = 0; i < 8; ++i)
+            permuteAvx2(r[4 * i], r[4 * i + 1], r[4 * i + 2], r[4 * i + 3]);
+
+        // Columns: register j of a row holds the word pairs of columns 2j
+        // and 2j + 1. Pairing the halves of two rows gives A, B, C and D
+        // for both columns, which are mixed and then split back.
+        for (size_t j = 0; j < 4; ++j) {
+            __m256i low[4];
+            __m256i high[4];
+
+            for (size_t k = 0; k < 4; ++k) {
+                const __m256i upper = r[8 * k + j];
+                const __m256i lower = r[8 * k + 4 + j];
+                low[k] = _mm256_permute2x128_si256(upper, lower, 0x20);
+                high[k] = _mm256_permute2x128_si256(upper, lower, 0x31);
+            }
+
+            permuteAvx2(low[0], low[1], low[2], low[3]);
+            permuteAvx2(high[0], high[1], high[2], high[3]);
+
+            for (size_t k = 0; k < 4; ++k) {
+                r[8 * k + j] = _mm256_permute2x128_si256(low[k], high[k], 0x20);
+                r[8 * k + 4 + j] = _mm256_permute2x128_si256(low[k], high[k], 0x31);
+            }
+        }
+
+        for (size_t i = 0; i < REGISTERS; ++i)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(next.v + 4 * i), _mm256_xor_si256(tmp[i], r[i]));
+    }
+
+    // ==================== CPU detection ====================
+
+    bool cpuHasSse2()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+#else
+        return __builtin_cpu_supports("sse2");
+#endif
+    }
+
+    bool cpuHasAvx2()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        // The OS must also save the YMM registers on context switch
+        __cpuid(info, 1);
+        bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+
+        __cpuidex(info, 7, 0);
+        return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+#endif // ARGON2_X86
+
+    // ==================== Dispatch ====================
+
+    using FillBlock = void (*)(const Block&, const Block&, Block&, bool);
+
+    struct KernelTable {
+        PasswordHasher::Kernel kernel;
+        FillBlock fillBlock;
+    };
+
+    const KernelTable SCALAR_KERNEL = { PasswordHasher::SCALAR, fillBlockScalar };
+#ifdef ARGON2_X86
+    const KernelTable SSE2_KERNEL = { PasswordHasher::SSE2, fillBlockSse2 };
+    const KernelTable AVX2_KERNEL = { PasswordHasher::AVX2, fillBlockAvx2 };
+#endif
+
+    const KernelTable* kernelFor(PasswordHasher::Kernel kernel)
+    {
+#ifdef ARGON2_X86
+        if (kernel == PasswordHasher::AVX2)
+            return &AVX2_KERNEL;
+        if (kernel == PasswordHasher::SSE2)
+            return &SSE2_KERNEL;
+#endif
+        return &SCALAR_KERNEL;
+    }
+
+    std::atomic<const KernelTable*>& selectedKernel()
+    {
+        static std::atomic<const KernelTable*> selected(kernelFor(PasswordHasher::bestSupportedKernel()));
+        return selected;
+    }
+
+    // ==================== Segments ====================
+
+    struct Instance {
+        std::vector<Block> memory;
+        uint32_t passes;
+        uint32_t lanes;
+        uint32_t laneLength;
+        uint32_t segmentLength;
+        uint32_t memoryBlocks;
+    };
+
+    uint32_t referenceIndex(const Instance& instance, uint32_t pass, uint32_t slice,
+        uint32_t index, uint32_t pseudoRand, bool sameLane)
+    {
+        uint32_t areaSize;
+
+        if (pass == 0) {
+            if (slice == 0)
+                areaSize = index - 1;
+            else if (sameLane)
+                areaSize = slice * instance.segmentLength + index - 1;
+            else
+                areaSize = slice * instance.segmentLength + (index == 0 ? -1 : 0);
+        }
+        else {
+            if (sameLane)
+                areaSize = instance.laneLength - instance.segmentLength + index - 1;
+            else
+                areaSize = instance.laneLength - instance.segmentLength + (index == 0 ? -1 : 0);
+        }
+
+        uint64_t relative = pseudoRand;
+        relative = (relative * relative) >> 32;
+        relative = areaSize - 1 - ((areaSize * relative) >> 32);
+
+        uint32_t start = 0;
+        if (pass != 0)
+            start = (slice == SYNC_POINTS - 1) ? 0 : (slice + 1) * instance.segmentLength;
+
+        return static_cast<uint32_t>((start + relative) % instance.laneLength);
+    }
+
+    void fillSegment(Instance& instance, uint32_t pass, uint32_t lane, uint32_t slice)
+    {
+        // Argon2id: data-independent addressing for the first half of pass 0
+        const bool independent = pass == 0 && slice < SYNC_POINTS / 2;
+        const FillBlock fillBlock = selectedKernel().load(std::memory_order_relaxed)->fillBlock;
+
+        Block addressBlock{};
+        Block inputBlock{};
+        Block zeroBlock{};
+
+        auto nextAddresses = [&]() {
+            ++inputBlock.v[6];
+            fillBlock(zeroBlock, inputBlock, addressBlock, false);
+            fillBlock(zeroBlock, addressBlock, addressBlock, false);
+        };
+
+        if (independent) {
+            inputBlock.v[0] = pass;
+            inputBlock.v[1] = lane;
+            inputBlock.v[2] = slice;
+            inputBlock.v[3] = instance.memoryBlocks;
+            inputBlock.v[4] = instance.passes;
+            inputBlock.v[5] = ARGON2_TYPE_ID;
+        }
+
+        uint32_t start = 0;
+        if (pass == 0 && slice == 0) {
+            start = 2; // the first two blocks of each lane are seeded from H0
+            if (independent)
+                nextAddresses();
+        }
+
+        uint32_t current = lane * instance.laneLength + slice * instance.segmentLength + start;
+        uint32_t previous = (current % instance.laneLength == 0)
+            ? current + instance.laneLength - 1
+            : current - 1;
+
+        for (uint32_t i = start; i < instance.segmentLength; ++i, ++current, ++previous) {
+            if (current % instance.laneLength == 1)
+                previous = current - 1;
+
+            uint64_t pseudoRand;
+            if (independent) {
+                if (i % QWORDS_IN_BLOCK == 0)
+                    nextAddresses();
+                pseudoRand = addressBlock.v[i % QWORDS_IN_BLOCK];
+            }
+            else {
+                pseudoRand = instance.memory[previous].v[0];
+            }
+
+            uint32_t refLane = static_cast<uint32_t>((pseudoRand >> 32) % instance.lanes);
+            if (pass == 0 && slice == 0)
+                refLane = lane;
+
+            uint32_t refIndex = referenceIndex(instance, pass, slice, i,
+                static_cast<uint32_t>(pseudoRand), refLane == lane);
+
+            const Block& ref = instance.memory[static_cast<size_t>(instance.laneLength) * refLane + refIndex];
+            fillBlock(instance.memory[previous], ref, instance.memory[current], pass != 0);
+        }
+    }
+
+    // ==================== Encoding ====================
+
+    const char BASE64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::string toBase64(const std::vector<uint8_t>& data)
+    {
+        std::string out;
+        uint32_t buffer = 0;
+        int bits = 0;
+
+        for (uint8_t byte : data) {
+            buffer = (buffer << 8) | byte;
+            bits += 8;
+            while (bits >= 6) {
+                bits -= 6;
+                out += BASE64[(buffer >> bits) & 0x3F];
+            }
+        }
+
+        if (bits > 0)
+            out += BASE64[(buffer << (6 - bits)) & 0x3F];
+
+        return out; // unpadded, as in the PHC string format
+    }
+
+    bool fromBase64(const std::string& text, std::vector<uint8_t>& out)
+    {
+        out.clear();
+        uint32_t buffer = 0;
+        int bits = 0;
+
+        for (char c : text) {
+            const char* pos = std::strchr(BASE64, c);
+            if (c == '\0' || pos == nullptr)
+                return false;
+
+            buffer = (buffer << 6) | static_cast<uint32_t>(pos - BASE64);
+            bits += 6;
+            if (bits >= 8) {
+                bits -= 8;
+                out.push_back(static_cast<uint8_t>(buffer >> bits));
+            }
+        }
+
+        return true;
+    }
+
+    struct Decoded {
+        PasswordHasher::Params params;
+        std::vector<uint8_t> salt;
+        std::vector<uint8_t> tag;
+    };
+
+    bool decode(const std::string& encoded, Decoded& decoded)
+    {
+        unsigned version = 0, memory = 0, iterations = 0, lanes = 0;
+        int consumed = 0;
+
+        if (std::sscanf(encoded.c_str(), "$argon2id$v=%u$m=%u,t=%u,p=%u$%n",
+                &version, &memory, &iterations, &lanes, &consumed) != 4 || consumed == 0)
+            return false;
+
+        // Caps first, so the lane check below cannot overflow
+        if (version != ARGON2_VERSION || iterations == 0 || lanes == 0
+            || iterations > PasswordHasher::MAX_ITERATIONS || lanes > PasswordHasher::MAX_LANES
+            || memory > PasswordHasher::MAX_MEMORY_KIB || memory < 8 * lanes)
+            return false;
+
+        size_t split = encoded.find('$', consumed);
+        if (split == std::string::npos)
+            return false;
+
+        decoded.params.memoryKiB = memory;
+        decoded.params.iterations = iterations;
+        decoded.params.lanes = lanes;
+
+        return fromBase64(encoded.substr(consumed, split - consumed), decoded.salt)
+            && fromBase64(encoded.substr(split + 1), decoded.tag)
+            && !decoded.salt.empty() && !decoded.tag.empty();
+    }
+
+    bool constantTimeEquals(const uint8_t* a, size_t aLength, const uint8_t* b, size_t bLength)
+    {
+        // Length is not secret; only the contents are compared in constant time
+        if (aLength != bLength)
+            return false;
+
+        uint8_t diff = 0;
+        for (size_t i = 0; i < aLength; ++i)
+            diff |= a[i] ^ b[i];
+
+        return diff == 0;
+    }
+
+}
+
+// ==================== Constructors ====================
+
+PasswordHasher::PasswordHasher()
+    : params()
+{
+}
+
+PasswordHasher::PasswordHasher(Params params)
+    : params(params)
+{
+    // Within the caps, or verify() would refuse the hashes this makes
+    this->params.lanes = std::clamp<uint32_t>(this->params.lanes, 1, MAX_LANES);
+    this->params.iterations = std::clamp<uint32_t>(this->params.iterations, 1, MAX_ITERATIONS);
+    this->params.memoryKiB = std::clamp(this->params.memoryKiB, 8 * this->params.lanes, MAX_MEMORY_KIB);
+}
+
+// ==================== Hashing ====================
+
+std::string PasswordHasher::hash(const std::string& password) const
+{
+    std::random_device random;
+    std::vector<uint8_t> salt(SALT_LENGTH);
+    for (uint8_t& byte : salt)
+        byte = static_cast<uint8_t>(random());
+
+    std::vector<uint8_t> tag = argon2id(password, salt, params);
+
+    return "$argon2id$v=19$m=" + std::to_string(params.memoryKiB)
+        + ",t=" + std::to_string(params.iterations)
+        + ",p=" + std::to_string(params.lanes)
+        + "$" + toBase64(salt) + "$" + toBase64(tag);
+}
+
+bool PasswordHasher::needsRehash(const std::string& stored) const
+{
+    Decoded decoded;
+    if (!decode(stored, decoded))
+        return true;
+
+    return decoded.params.memoryKiB != params.memoryKiB
+        || decoded.params.iterations != params.iterations
+        || decoded.params.lanes != params.lanes
+        || decoded.tag.size() != TAG_LENGTH;
+}
+
+bool PasswordHasher::verify(const std::string& password, const std::string& stored)
+{
+    Decoded decoded;
+
+    if (!decode(stored, decoded)) {
+        return constantTimeEquals(
+            reinterpret_cast<const uint8_t*>(password.data()), password.size(),
+            reinterpret_cast<const uint8_t*>(stored.data()), stored.size());
+    }
+
+    std::vector<uint8_t> tag = argon2id(password, decoded.salt, decoded.params, decoded.tag.size());
+    return constantTimeEquals(tag.data(), tag.size(), decoded.tag.data(), decoded.tag.size());
+}
+
+bool PasswordHasher::isEncodedHash(const std::string& stored)
+{
+    Decoded decoded;
+    return decode(stored, decoded);
+}
+
+// ==================== Calibration ====================
+
+PasswordHasher::Params PasswordHasher::calibrate(std::chrono::milliseconds target,
+    uint32_t lanes, uint32_t maxMemoryKiB)
+{
+    Params params;
+    params.lanes = std::clamp<uint32_t>(lanes, 1, MAX_LANES);
+    params.iterations = 2;
+    maxMemoryKiB = std::min(maxMemoryKiB, MAX_MEMORY_KIB);
+    params.memoryKiB = std::max<uint32_t>(8 * 1024, 8 * params.lanes);
+
+    const std::vector<uint8_t> salt(SALT_LENGTH, 0x5A);
+
+    auto measure = [&](const Params& candidate) {
+        auto start = std::chrono::steady_clock::now();
+        argon2id("calibration", salt, candidate);
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+    };
+
+    // Memory is the cost that hurts attackers most, so grow it first
+    Params best = params;
+    while (params.memoryKiB <= maxMemoryKiB && measure(params) <= target) {
+        best = params;
+        params.memoryKiB *= 2;
+    }
+
+    // Spend any remaining budget on extra passes at the chosen memory size
+    if (best.memoryKiB * 2 > maxMemoryKiB) {
+        params = best;
+        while (params.iterations < MAX_ITERATIONS) {
+            ++params.iterations;
+            if (measure(params) > target)
+                break;
+            best = params;
+        }
+    }
+
+    return best;
+}
+
+// ==================== Argon2id ====================
+
+std::vector<uint8_t> PasswordHasher::argon2id(const std::string& password,
+    const std::vector<uint8_t>& salt, const Params& params, size_t tagLength,
+    const std::vector<uint8_t>& secret, const std::vector<uint8_t>& associatedData)
+{
+    const uint32_t lanes = std::max<uint32_t>(1, params.lanes);
+    const uint32_t passes = std::max<uint32_t>(1, params.iterations);
+
+    // H0 binds every parameter and input into one 64-byte seed
+    uint8_t h0[64 + 8];
+    Blake2b seed(64);
+    seed.updateLE32(lanes);
+    seed.updateLE32(static_cast<uint32_t>(tagLength));
+    seed.updateLE32(params.memoryKiB);
+    seed.updateLE32(passes);
+    seed.updateLE32(ARGON2_VERSION);
+    seed.updateLE32(ARGON2_TYPE_ID);
+    seed.updateLE32(static_cast<uint32_t>(password.size()));
+    seed.update(password.data(), password.size());
+    seed.updateLE32(static_cast<uint32_t>(salt.size()));
+    seed.update(salt.data(), salt.size());
+    seed.updateLE32(static_cast<uint32_t>(secret.size()));
+    seed.update(secret.data(), secret.size());
+    seed.updateLE32(static_cast<uint32_t>(associatedData.size()));
+    seed.update(associatedData.data(), associatedData.size());
+    seed.final(h0);
+
+    Instance instance;
+    uint32_t memoryBlocks = std::max(params.memoryKiB, 2 * SYNC_POINTS * lanes);
+    instance.segmentLength = memoryBlocks / (lanes * SYNC_POINTS);
+    instance.memoryBlocks = instance.segmentLength * lanes * SYNC_POINTS;
+    instance.laneLength = instance.segmentLength * SYNC_POINTS;
+    instance.passes = passes;
+    instance.lanes = lanes;
+    instance.memory.resize(instance.memoryBlocks);
+
+    // First two blocks of every lane
+    uint8_t blockBytes[sizeof(Block)];
+    for (uint32_t lane = 0; lane < lanes; ++lane) {
+        for (uint32_t column = 0; column < 2; ++column) {
+            store32(h0 + 64, column);
+            store32(h0 + 68, lane);
+            hashLong(blockBytes, sizeof(blockBytes), h0, sizeof(h0));
+
+            Block& block = instance.memory[static_cast<size_t>(lane) * instance.laneLength + column];
+            for (size_t i = 0; i < QWORDS_IN_BLOCK; ++i)
+                block.v[i] = load64(blockBytes + 8 * i);
+        }
+    }
+
+    // Lanes only read each other's finished slices, so a slice can be
+    // filled on all lanes at once; the join is the synchronisation point
+    for (uint32_t pass = 0; pass < passes; ++pass) {
+        for (uint32_t slice = 0; slice < SYNC_POINTS; ++slice) {
+            if (lanes == 1) {
+                fillSegment(instance, pass, 0, slice);
+                continue;
+            }
+
+            std::vector<std::thread> workers;
+            workers.reserve(lanes);
+            for (uint32_t lane = 0; lane < lanes; ++lane)
+                workers.emplace_back(fillSegment, std::ref(instance), pass, lane, slice);
+            for (std::thread& worker : workers)
+                worker.join();
+        }
+    }
+
+    // XOR the last block of every lane, then stretch to the tag length
+    Block final = instance.memory[instance.laneLength - 1];
+    for (uint32_t lane = 1; lane < lanes; ++lane) {
+        const Block& last = instance.memory[static_cast<size_t>(lane) * instance.laneLength + instance.laneLength - 1];
+        for (size_t i = 0; i < QWORDS_IN_BLOCK; ++i)
+            final.v[i] ^= last.v[i];
+    }
+
+    for (size_t i = 0; i < QWORDS_IN_BLOCK; ++i)
+        store64(blockBytes + 8 * i, final.v[i]);
+
+    std::vector<uint8_t> tag(tagLength);
+    hashLong(tag.data(), tagLength, blockBytes, sizeof(blockBytes));
+    return tag;
+}
+
+// ==================== Kernel selection ====================
+
+PasswordHasher::Kernel PasswordHasher::activeKernel()
+{
+    return selectedKernel().load()->kernel;
+}
+
+PasswordHasher::Kernel PasswordHasher::bestSupportedKernel()
+{
+#ifdef ARGON2_X86
+    static const Kernel best = cpuHasAvx2() ? AVX2 : cpuHasSse2() ? SSE2 : SCALAR;
+    return best;
+#else
+    return SCALAR;
+#endif
+}
+
+void PasswordHasher::setKernel(Kernel kernel)
+{
+    Kernel best = bestSupportedKernel();
+    selectedKernel().store(kernelFor(kernel <= best ? kernel : best));
+}
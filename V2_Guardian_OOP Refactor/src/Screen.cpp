@@ -0,0 +1,190 @@
+#include "../include/Screen.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+#ifdef _WIN32
+#include <conio.h>
+#else
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+// ==================== Display utilities ====================
+
+void Screen::clear()
+{
+#ifdef _WIN32
+    system("cls");
+#else
+    std::cout << "\033[2J\033[H";
+    std::cout.flush();
+#endif
+}
+
+void Screen::pause()
+{
+    std::cout << "\nPress Enter to continue..." << std::endl;
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+}
+
+void Screen::printLine(char character, int length)
+{
+    std::cout << std::string(length, character) << std::endl;
+}
+
+void Screen::printHeader(const std::string& title)
+{
+    printLine();
+    std::cout << "  " << title << std::endl;
+    printLine();
+}
+
+void Screen::printError(const std::string& message)
+{
+    std::cout << "\n[ERROR] " << message << std::endl;
+}
+
+void Screen::printSuccess(const std::string& message)
+{
+    std::cout << "\n[SUCCESS] " << message << std::endl;
+}
+
+void Screen::printWarning(const std::string& message)
+{
+    std::cout << "\n[WARNING] " << message << std::endl;
+}
+
+void Screen::printInfo(const std::string& message)
+{
+    std::cout << "\n[INFO] " << message << std::endl;
+}
+
+// ==================== Menu utilities ====================
+
+void Screen::displayMenu(const std::vector<std::string>& options, const std::string& title)
+{
+    printHeader(title);
+    for (size_t i = 0; i < options.size(); ++i)
+        std::cout << "  " << (i + 1) << ". " << options[i] << std::endl;
+    printLine();
+}
+
+int Screen::getMenuChoice(int minOption, int maxOption)
+{
+    while (true) {
+        std::cout << "\nEnter your choice: ";
+
+        int choice;
+        std::cin >> choice;
+
+        if (std::cin.fail()) {
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            printError("Invalid input. Please enter a number.");
+            continue;
+        }
+
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+        if (choice >= minOption && choice <= maxOption)
+            return choice;
+
+        printError("Please enter a number between " + std::to_string(minOption)
+            + " and " + std::to_string(maxOption) + ".");
+    }
+}
+
+// ==================== Input utilities ====================
+
+std::string Screen::getInput(const std::string& prompt)
+{
+    std::cout << prompt;
+
+    std::string input;
+    std::getline(std::cin, input);
+
+    // Trim whitespace
+    input.erase(0, input.find_first_not_of(" \t"));
+    input.erase(input.find_last_not_of(" \t") + 1);
+    return input;
+}
+
+std::string Screen::getPasswordInput(const std::string& prompt)
+{
+    std::cout << prompt;
+    std::string password;
+
+#ifdef _WIN32
+    int c;
+    while ((c = _getch()) != '\r' && c != '\n') {
+        if (c == '\b') {
+            if (!password.empty()) {
+                password.pop_back();
+                std::cout << "\b \b";
+            }
+        }
+        else {
+            password += static_cast<char>(c);
+            std::cout << '*';
+        }
+    }
+#else
+    termios oldSettings;
+    tcgetattr(STDIN_FILENO, &oldSettings);
+    termios hidden = oldSettings;
+    hidden.c_lflag &= ~ECHO;
+    tcsetattr(STDIN_FILENO, TCSANOW, &hidden);
+
+    std::getline(std::cin, password);
+
+    tcsetattr(STDIN_FILENO, TCSANOW, &oldSettings);
+#endif
+
+    std::cout << std::endl;
+    return password;
+}
+
+bool Screen::confirmAction(const std::string& prompt)
+{
+    std::cout << "\n[WARNING] " << prompt << " (y/n): ";
+
+    std::string answer;
+    std::getline(std::cin, answer);
+    return !answer.empty() && (answer[0] == 'y' || answer[0] == 'Y');
+}
+
+// ==================== Table display ====================
+
+void Screen::displayTable(const std::vector<std::string>& headers,
+    const std::vector<std::vector<std::string>>& rows)
+{
+    std::vector<size_t> widths(headers.size());
+    for (size_t i = 0; i < headers.size(); ++i)
+        widths[i] = headers[i].size();
+
+    for (const auto& row : rows) {
+        for (size_t i = 0; i < row.size() && i < widths.size(); ++i)
+            widths[i] = std::max(widths[i], row[i].size());
+    }
+
+    auto printRow = [&](const std::vector<std::string>& cells) {
+        std::cout << "|";
+        for (size_t i = 0; i < widths.size(); ++i) {
+            const std::string cell = i < cells.size() ? cells[i] : "";
+            std::cout << " " << cell << std::string(widths[i] - cell.size(), ' ') << " |";
+        }
+        std::cout << std::endl;
+    };
+
+    printRow(headers);
+
+    std::cout << "|";
+    for (size_t width : widths)
+        std::cout << std::string(width + 2, '-') << "|";
+    std::cout << std::endl;
+
+    for (const auto& row : rows)
+        printRow(row);
+}
@@ -0,0 +1,162 @@
+#include "../include/SessionStore.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+// ==================== Token ====================
+
+std::string SessionStore::Token::toString() const
+{
+    char text[33];
+    std::snprintf(text, sizeof(text), "%016llx%016llx",
+        static_cast<unsigned long long>(high), static_cast<unsigned long long>(low));
+    return text;
+}
+
+bool SessionStore::Token::fromString(const std::string& text, Token& token)
+{
+    if (text.size() != 32)
+        return false;
+
+    Token parsed;
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        uint64_t digit;
+
+        if (c >= '0' && c <= '9')      digit = c - '0';
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else return false;
+
+        uint64_t& half = i < 16 ? parsed.high : parsed.low;
+        half = (half << 4) | digit;
+    }
+
+    token = parsed;
+    return true;
+}
+
+// ==================== Constructor ====================
+
+SessionStore::SessionStore(std::chrono::seconds ttl)
+    : start(std::chrono::steady_clock::now()),
+      ttlSeconds(static_cast<uint32_t>(std::max<long long>(1, ttl.count()))),
+      wheelSlots(std::min(ttlSeconds, MAX_WHEEL_SLOTS - 1) + 1)
+{
+}
+
+// ==================== Session lifecycle ====================
+
+SessionStore::Token SessionStore::create(int userId)
+{
+    Token token = randomToken();
+    uint32_t expiresAt = now() + ttlSeconds;
+
+    Shard& shard = shardFor(token);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    if (shard.wheel.empty())
+        shard.wheel.resize(wheelSlots);
+
+    shard.sessions[token] = Session{ userId, expiresAt };
+    shard.wheel[expiresAt % wheelSlots].push_back(token);
+    return token;
+}
+
+int SessionStore::lookup(const Token& token)
+{
+    const uint32_t current = now();
+
+    Shard& shard = shardFor(token);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.sessions.find(token);
+    if (it == shard.sessions.end() || it->second.expiresAt <= current)
+        return 0;
+
+    // Sliding expiry: the wheel entry stays put and is rescheduled when
+    // its old slot comes due
+    it->second.expiresAt = current + ttlSeconds;
+    return it->second.userId;
+}
+
+bool SessionStore::revoke(const Token& token)
+{
+    Shard& shard = shardFor(token);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // Its wheel entry is skipped when the slot is swept
+    return shard.sessions.erase(token) > 0;
+}
+
+// ==================== Expiry ====================
+
+size_t SessionStore::expire()
+{
+    const uint32_t current = now();
+    size_t expired = 0;
+
+    for (Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        // One full turn already visits every slot; an unused shard has none
+        uint32_t steps = shard.wheel.empty() ? 0 : std::min(current - shard.wheelTime, wheelSlots);
+        uint32_t first = current - steps + 1;
+
+        for (uint32_t second = first; steps > 0 && second <= current; ++second) {
+            std::vector<Token> due;
+            due.swap(shard.wheel[second % wheelSlots]);
+
+            for (const Token& token : due) {
+                auto it = shard.sessions.find(token);
+                if (it == shard.sessions.end())
+                    continue; // revoked
+
+                if (it->second.expiresAt <= current) {
+                    shard.sessions.erase(it);
+                    ++expired;
+                }
+                else {
+                    shard.wheel[it->second.expiresAt % wheelSlots].push_back(token);
+                }
+            }
+        }
+
+        shard.wheelTime = current;
+    }
+
+    return expired;
+}
+
+size_t SessionStore::size() const
+{
+    size_t total = 0;
+    for (const Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.sessions.size();
+    }
+    return total;
+}
+
+// ==================== Helpers ====================
+
+uint32_t SessionStore::now() const
+{
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+SessionStore::Token SessionStore::randomToken()
+{
+    // random_device is the OS CSPRNG on the platforms we build for
+    thread_local std::random_device random;
+
+    auto next64 = [&]() {
+        return (static_cast<uint64_t>(random()) << 32) | random();
+    };
+
+    Token token;
+    token.high = next64();
+    token.low = next64();
+    return token;
+}
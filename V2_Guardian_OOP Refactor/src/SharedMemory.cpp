@@ -0,0 +1,152 @@
+#include "../include/SharedMemory.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ==================== Destructor ====================
+
+SharedMemory::~SharedMemory()
+{
+    close();
+}
+
+// ==================== Segment management ====================
+
+bool SharedMemory::create(const std::string& name, size_t size)
+{
+    close();
+
+    if (size == 0)
+        return false;
+
+    const std::string systemName = SharedMemory::systemName(name);
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(static_cast<unsigned long long>(size) >> 32),
+        static_cast<DWORD>(size), systemName.c_str());
+    if (handle == nullptr)
+        return false;
+
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    base = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (base == nullptr) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    mapping = handle;
+#else
+    int fd = shm_open(systemName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0)
+        return false;
+
+    void* address = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+        address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (address == MAP_FAILED) {
+        shm_unlink(systemName.c_str());
+        return false;
+    }
+
+    base = address;
+#endif
+
+    length = size;
+    return true;
+}
+
+bool SharedMemory::open(const std::string& name)
+{
+    close();
+
+    const std::string systemName = SharedMemory::systemName(name);
+
+#ifdef _WIN32
+    HANDLE handle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, systemName.c_str());
+    if (handle == nullptr)
+        return false;
+
+    base = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+
+    MEMORY_BASIC_INFORMATION region;
+    if (base == nullptr || VirtualQuery(base, &region, sizeof(region)) == 0) {
+        if (base != nullptr)
+            UnmapViewOfFile(base);
+        base = nullptr;
+        CloseHandle(handle);
+        return false;
+    }
+
+    // Rounded up to whole pages; callers size their reads from the contents
+    mapping = handle;
+    length = region.RegionSize;
+#else
+    int fd = shm_open(systemName.c_str(), O_RDWR, 0600);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    void* address = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+        address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (address == MAP_FAILED)
+        return false;
+
+    base = address;
+    length = static_cast<size_t>(info.st_size);
+#endif
+
+    return true;
+}
+
+void SharedMemory::close()
+{
+    if (base == nullptr)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(base);
+    CloseHandle(mapping);
+    mapping = nullptr;
+#else
+    munmap(base, length);
+#endif
+
+    base = nullptr;
+    length = 0;
+}
+
+// Processes that still have the segment mapped keep using it
+bool SharedMemory::remove(const std::string& name)
+{
+#ifdef _WIN32
+    (void)name;
+    return true;
+#else
+    return shm_unlink(systemName(name).c_str()) == 0;
+#endif
+}
+
+std::string SharedMemory::systemName(const std::string& name)
+{
+#ifdef _WIN32
+    return "Local\\" + name;
+#else
+    return "/" + name;
+#endif
+}
@@ -0,0 +1,95 @@
+#include "../include/ThreadPool.h"
+#include <algorithm>
+
+// ==================== Constructor / Destructor ====================
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    threadCount = std::max<size_t>(1, threadCount);
+
+    for (size_t i = 0; i < threadCount; ++i)
+        queues.push_back(std::make_unique<Queue>());
+
+    for (size_t i = 0; i < threadCount; ++i)
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+// ==================== Scheduling ====================
+
+void ThreadPool::enqueue(Task task)
+{
+    // Count first so a worker never sees a task it has not been told about
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        ++pending;
+    }
+
+    Queue& queue = *queues[nextQueue++ % queues.size()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    wake.notify_one();
+}
+
+bool ThreadPool::popLocal(size_t index, Task& task)
+{
+    Queue& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.tasks.empty())
+        return false;
+
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal(size_t index, Task& task)
+{
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        Queue& victim = *queues[(index + offset) % queues.size()];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+
+        if (!lock.owns_lock() || victim.tasks.empty())
+            continue;
+
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t index)
+{
+    while (true) {
+        Task task;
+
+        if (popLocal(index, task) || steal(index, task)) {
+            --pending;
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this]() { return stopping || pending > 0; });
+
+        // Drain everything already submitted before shutting down
+        if (stopping && pending == 0)
+            return;
+    }
+}
@@ -0,0 +1,160 @@
+#include "../include/Timestamp.h"
+#include <ctime>
+
+namespace {
+
+    // Days between 1970-01-01 and y-m-d in the proleptic Gregorian calendar
+    // (H. Hinnant, "chrono-Compatible Low-Level Date Algorithms")
+    int64_t daysFromCivil(int64_t y, unsigned m, unsigned d)
+    {
+        y -= m <= 2;
+        const int64_t era = (y >= 0 ? y : y - 399) / 400;
+        const unsigned yoe = static_cast<unsigned>(y - era * 400);
+        const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<int64_t>(doe) - 719468;
+    }
+
+    void civilFromDays(int64_t days, int64_t& y, unsigned& m, unsigned& d)
+    {
+        days += 719468;
+        const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        const unsigned doe = static_cast<unsigned>(days - era * 146097);
+        const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const unsigned mp = (5 * doy + 2) / 153;
+
+        d = doy - (153 * mp + 2) / 5 + 1;
+        m = mp < 10 ? mp + 3 : mp - 9;
+        y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+    }
+
+    unsigned daysInMonth(unsigned year, unsigned month)
+    {
+        static const unsigned DAYS[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+        const bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+        return month == 2 && leap ? 29 : DAYS[month - 1];
+    }
+
+    bool readDigits(std::string_view text, size_t pos, size_t count, unsigned& value)
+    {
+        value = 0;
+        for (size_t i = pos; i < pos + count; ++i) {
+            if (text[i] < '0' || text[i] > '9')
+                return false;
+            value = value * 10 + (text[i] - '0');
+        }
+        return true;
+    }
+
+    void writeDigits(char* out, unsigned value, int count)
+    {
+        for (int i = count - 1; i >= 0; --i) {
+            out[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+    }
+
+}
+
+// ==================== Clock ====================
+
+// localtime is the expensive part (zone rules, often a global lock), so
+// each thread converts a given second only once
+int64_t Timestamp::now()
+{
+    thread_local time_t cachedSecond = -1;
+    thread_local int64_t cachedLocal = 0;
+
+    time_t now = time(nullptr);
+    if (now == cachedSecond)
+        return cachedLocal;
+
+    tm ltm;
+
+#ifdef _WIN32
+    localtime_s(&ltm, &now);
+#else
+    localtime_r(&now, &ltm);
+#endif
+
+    int64_t days = daysFromCivil(1900 + ltm.tm_year, 1 + ltm.tm_mon, ltm.tm_mday);
+
+    cachedSecond = now;
+    cachedLocal = days * 86400 + ltm.tm_hour * 3600 + ltm.tm_min * 60 + ltm.tm_sec;
+    return cachedLocal;
+}
+
+std::string_view Timestamp::nowText()
+{
+    thread_local int64_t cachedSeconds = 0;
+    thread_local char cachedText[TEXT_LENGTH];
+
+    int64_t seconds = now();
+    if (seconds != cachedSeconds) {
+        formatTo(seconds, cachedText);
+        cachedSeconds = seconds;
+    }
+
+    return std::string_view(cachedText, TEXT_LENGTH);
+}
+
+// ==================== Text conversion ====================
+
+bool Timestamp::parse(std::string_view text, int64_t& seconds)
+{
+    if (text.empty()) {
+        seconds = 0;
+        return true;
+    }
+
+    unsigned year, month, day, hour, minute, second;
+
+    if (text.size() != TEXT_LENGTH
+        || text[4] != '-' || text[7] != '-' || text[10] != ' ' || text[13] != ':' || text[16] != ':'
+        || !readDigits(text, 0, 4, year) || !readDigits(text, 5, 2, month)
+        || !readDigits(text, 8, 2, day) || !readDigits(text, 11, 2, hour)
+        || !readDigits(text, 14, 2, minute) || !readDigits(text, 17, 2, second)
+        || month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month)
+        || hour > 23 || minute > 59 || second > 60)
+        return false;
+
+    seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    return true;
+}
+
+std::string Timestamp::format(int64_t seconds)
+{
+    if (seconds == 0)
+        return std::string();
+
+    std::string text(TEXT_LENGTH, ' ');
+    formatTo(seconds, &text[0]);
+    return text;
+}
+
+void Timestamp::formatTo(int64_t seconds, char* out)
+{
+    int64_t days = seconds / 86400;
+    int64_t rest = seconds % 86400;
+    if (rest < 0) {
+        rest += 86400;
+        --days;
+    }
+
+    int64_t year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+
+    writeDigits(out, static_cast<unsigned>(year), 4);
+    out[4] = '-';
+    writeDigits(out + 5, month, 2);
+    out[7] = '-';
+    writeDigits(out + 8, day, 2);
+    out[10] = ' ';
+    writeDigits(out + 11, static_cast<unsigned>(rest / 3600), 2);
+    out[13] = ':';
+    writeDigits(out + 14, static_cast<unsigned>(rest / 60 % 60), 2);
+    out[16] = ':';
+    writeDigits(out + 17, static_cast<unsigned>(rest % 60), 2);
+}
@@ -0,0 +1,172 @@
+#include "../include/User.h"
+#include "../include/CsvTokenizer.h"
+#include "../include/Timestamp.h"
+#include <charconv>
+#include <cstring>
+#include <utility>
+
+// ==================== Constructors ====================
+
+User::User()
+    : id(0), usernameLength(0), passwordLength(0), emailLength(0), createdAt(0) {}
+
+// A field too long to store leaves an empty user with id 0, which
+// callers already skip as invalid
+User::User(int id, std::string_view username, std::string_view password,
+    std::string_view email)
+    : id(id), usernameLength(0), passwordLength(0), emailLength(0), createdAt(Timestamp::now())
+{
+    if (!assign(username, password, email))
+        this->id = 0;
+}
+
+User::User(int id, std::string_view username, std::string_view password,
+    std::string_view email, std::string_view createdDate)
+    : id(id), usernameLength(0), passwordLength(0), emailLength(0)
+{
+    if (!Timestamp::parse(createdDate, createdAt))
+        createdAt = 0;
+
+    if (!assign(username, password, email))
+        this->id = 0;
+}
+
+User::User(const User& other)
+    : id(other.id), usernameLength(0), passwordLength(0), emailLength(0), createdAt(other.createdAt)
+{
+    assign(other.getUsername(), other.getPassword(), other.getEmail());
+}
+
+User::User(User&& other) noexcept
+    : id(other.id), usernameLength(std::exchange(other.usernameLength, 0)),
+      passwordLength(std::exchange(other.passwordLength, 0)),
+      emailLength(std::exchange(other.emailLength, 0)),
+      createdAt(other.createdAt), strings(std::move(other.strings)) {}
+
+User& User::operator=(const User& other)
+{
+    if (this != &other) {
+        id = other.id;
+        createdAt = other.createdAt;
+        assign(other.getUsername(), other.getPassword(), other.getEmail());
+    }
+    return *this;
+}
+
+User& User::operator=(User&& other) noexcept
+{
+    if (this != &other) {
+        id = other.id;
+        createdAt = other.createdAt;
+        usernameLength = std::exchange(other.usernameLength, 0);
+        passwordLength = std::exchange(other.passwordLength, 0);
+        emailLength = std::exchange(other.emailLength, 0);
+        strings = std::move(other.strings);
+    }
+    return *this;
+}
+
+// ==================== Getters ====================
+
+int User::getId() const { return id; }
+
+std::string_view User::getUsername() const
+{
+    return std::string_view(strings.get(), usernameLength);
+}
+
+std::string_view User::getPassword() const
+{
+    return std::string_view(strings.get() + usernameLength, passwordLength);
+}
+
+std::string_view User::getEmail() const
+{
+    return std::string_view(strings.get() + usernameLength + passwordLength, emailLength);
+}
+
+int64_t User::getCreatedAt() const { return createdAt; }
+std::string User::getCreatedDate() const { return Timestamp::format(createdAt); }
+
+// ==================== Setters ====================
+
+// Each setter rebuilds the block; the argument may view the old one
+void User::setId(int id) { this->id = id; }
+bool User::setUsername(std::string_view username) { return assign(username, getPassword(), getEmail()); }
+bool User::setPassword(std::string_view password) { return assign(getUsername(), password, getEmail()); }
+bool User::setEmail(std::string_view email) { return assign(getUsername(), getPassword(), email); }
+
+// Lengths are stored in 16 bits; a longer field is refused, not cut
+bool User::assign(std::string_view username, std::string_view password, std::string_view email)
+{
+    if (username.size() > UINT16_MAX || password.size() > UINT16_MAX || email.size() > UINT16_MAX)
+        return false;
+
+    const uint16_t newUsernameLength = static_cast<uint16_t>(username.size());
+    const uint16_t newPasswordLength = static_cast<uint16_t>(password.size());
+    const uint16_t newEmailLength = static_cast<uint16_t>(email.size());
+    const size_t total = size_t(newUsernameLength) + newPasswordLength + newEmailLength;
+
+    // Build the new block before releasing the old one, which the views may point into
+    std::unique_ptr<char[]> block;
+    if (total > 0) {
+        block.reset(new char[total]);
+        std::memcpy(block.get(), username.data(), newUsernameLength);
+        std::memcpy(block.get() + newUsernameLength, password.data(), newPasswordLength);
+        std::memcpy(block.get() + newUsernameLength + newPasswordLength, email.data(), newEmailLength);
+    }
+
+    strings = std::move(block);
+    usernameLength = newUsernameLength;
+    passwordLength = newPasswordLength;
+    emailLength = newEmailLength;
+    return true;
+}
+
+// ==================== Validation ====================
+
+bool User::isValid() const
+{
+    return id > 0 && usernameLength > 0 && passwordLength > 0
+        && getEmail().find('@') != std::string_view::npos;
+}
+
+// ==================== Serialization ====================
+
+// Format: id,username,password,email,createdDate (CSV-quoted where needed)
+std::string User::toFileString() const
+{
+    std::string line = std::to_string(id);
+    line.reserve(line.size() + usernameLength + passwordLength + emailLength
+        + Timestamp::TEXT_LENGTH + 8);
+
+    for (std::string_view field : { getUsername(), getPassword(), getEmail() }) {
+        line += ',';
+        CsvTokenizer::appendField(line, field);
+    }
+
+    line += ',';
+    if (createdAt != 0) {
+        size_t end = line.size();
+        line.resize(end + Timestamp::TEXT_LENGTH);
+        Timestamp::formatTo(createdAt, &line[end]);
+    }
+
+    return line;
+}
+
+User User::fromFileString(std::string_view line)
+{
+    CsvTokenizer fields;
+
+    if (!fields.tokenize(line))
+        return User();
+
+    int id = 0;
+    std::string_view idField = fields.field(0);
+    auto parsed = std::from_chars(idField.data(), idField.data() + idField.size(), id);
+    if (parsed.ec != std::errc() || parsed.ptr != idField.data() + idField.size())
+        id = 0;
+
+    return User(id, fields.field(1), fields.field(2), fields.field(3), fields.field(4));
+}
@@ -0,0 +1,74 @@
+#include "../include/UserCursor.h"
+#include <utility>
+
+// ==================== Constructor ====================
+
+UserCursor::UserCursor(const std::string& path, unsigned fields, Filter filter,
+    size_t batchSize)
+    : fields(fields), filter(std::move(filter)), batchSize(batchSize == 0 ? 1 : batchSize)
+{
+    file.open(path); // an unreadable file simply yields no rows
+    batch.reserve(this->batchSize);
+}
+
+// ==================== Batch API ====================
+
+bool UserCursor::next(std::vector<User>& out)
+{
+    if (!fetch())
+        return false;
+
+    out.swap(batch);
+    batch.clear();
+    return true;
+}
+
+bool UserCursor::fetch()
+{
+    batch.clear();
+
+    while (batch.size() < batchSize && scanned < file.size()) {
+        size_t index = scanned++;
+
+        if (filter && !filter(RecordView{ &file, index }))
+            continue;
+
+        batch.push_back(project(index));
+    }
+
+    return !batch.empty();
+}
+
+User UserCursor::project(size_t index) const
+{
+    auto take = [&](Field field, std::string_view value) {
+        return (fields & field) ? std::string(value) : std::string();
+    };
+
+    return User((fields & ID) ? file.idAt(index) : 0,
+        take(USERNAME, file.usernameAt(index)),
+        take(PASSWORD, file.passwordAt(index)),
+        take(EMAIL, file.emailAt(index)),
+        take(CREATED_DATE, file.createdDateAt(index)));
+}
+
+// ==================== Iterator ====================
+
+UserCursor::iterator::iterator(UserCursor* cursor)
+    : cursor(cursor)
+{
+    if (!cursor->fetch())
+        this->cursor = nullptr;
+}
+
+UserCursor::iterator& UserCursor::iterator::operator++()
+{
+    if (++position < cursor->batch.size())
+        return *this;
+
+    position = 0;
+    if (!cursor->fetch())
+        cursor = nullptr;
+
+    return *this;
+}
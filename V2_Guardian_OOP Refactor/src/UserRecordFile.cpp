@@ -0,0 +1,261 @@
+#include "../include/UserRecordFile.h"
+#include "../include/AtomicFile.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    bool withinHeap(UserRecordFile::StringRef ref, uint64_t heapSize)
+    {
+        return uint64_t(ref.offset) + ref.length <= heapSize;
+    }
+
+}
+
+// ==================== Mapping ====================
+
+UserRecordFile::~UserRecordFile()
+{
+    close();
+}
+
+bool UserRecordFile::open(const std::string& path)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < (LONGLONG)sizeof(FileHeader)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE map = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!map) {
+        CloseHandle(file);
+        return false;
+    }
+
+    const void* data = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(map);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mapHandle = map;
+    mappingSize = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(FileHeader)) {
+        ::close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping keeps the file alive
+    if (data == MAP_FAILED)
+        return false;
+
+    mappingSize = static_cast<size_t>(st.st_size);
+#endif
+
+    mapping = data;
+
+    const char* base = static_cast<const char*>(mapping);
+    const FileHeader* candidate = reinterpret_cast<const FileHeader*>(base);
+
+    // Reject anything that is not a complete version 1 file. Offsets are
+    // checked by subtraction so a damaged header cannot overflow them.
+    bool valid = std::memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) == 0
+        && candidate->version == VERSION
+        && candidate->entrySize == sizeof(RecordEntry)
+        && candidate->entriesOffset >= sizeof(FileHeader)
+        && candidate->entriesOffset % alignof(RecordEntry) == 0
+        && candidate->entriesOffset <= candidate->heapOffset
+        && (uint64_t)candidate->recordCount * sizeof(RecordEntry) <= candidate->heapOffset - candidate->entriesOffset
+        && candidate->heapOffset <= mappingSize
+        && candidate->heapSize <= mappingSize - candidate->heapOffset;
+
+    // Every field is read straight from the heap, so every reference must
+    // stay inside it
+    const RecordEntry* candidateEntries = valid
+        ? reinterpret_cast<const RecordEntry*>(base + candidate->entriesOffset) : nullptr;
+    for (uint32_t i = 0; valid && i < candidate->recordCount; ++i) {
+        const RecordEntry& entry = candidateEntries[i];
+        valid = withinHeap(entry.username, candidate->heapSize)
+            && withinHeap(entry.password, candidate->heapSize)
+            && withinHeap(entry.email, candidate->heapSize)
+            && withinHeap(entry.createdDate, candidate->heapSize);
+    }
+
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    header = candidate;
+    entries = candidateEntries;
+    heap = base + header->heapOffset;
+    return true;
+}
+
+void UserRecordFile::close()
+{
+    if (mapping) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping);
+        CloseHandle(mapHandle);
+        CloseHandle(fileHandle);
+        mapHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        munmap(const_cast<void*>(mapping), mappingSize);
+#endif
+    }
+
+    mapping = nullptr;
+    mappingSize = 0;
+    header = nullptr;
+    entries = nullptr;
+    heap = nullptr;
+}
+
+// ==================== Record access ====================
+
+User UserRecordFile::userAt(size_t index) const
+{
+    return User(idAt(index),
+        std::string(usernameAt(index)),
+        std::string(passwordAt(index)),
+        std::string(emailAt(index)),
+        std::string(createdDateAt(index)));
+}
+
+size_t UserRecordFile::findById(int id) const
+{
+    const RecordEntry* end = entries + size();
+    const RecordEntry* it = std::lower_bound(entries, end, id,
+        [](const RecordEntry& entry, int value) { return entry.id < value; });
+
+    return (it != end && it->id == id) ? static_cast<size_t>(it - entries) : npos;
+}
+
+size_t UserRecordFile::findByUsername(std::string_view username) const
+{
+    for (size_t i = 0; i < size(); ++i) {
+        if (entries[i].username.length == username.size() && usernameAt(i) == username)
+            return i;
+    }
+    return npos;
+}
+
+size_t UserRecordFile::findByEmail(std::string_view email) const
+{
+    for (size_t i = 0; i < size(); ++i) {
+        if (entries[i].email.length == email.size() && emailAt(i) == email)
+            return i;
+    }
+    return npos;
+}
+
+// ==================== Writing ====================
+
+bool UserRecordFile::write(const std::string& path, const std::vector<User>& users)
+{
+    std::vector<const User*> sorted;
+    sorted.reserve(users.size());
+    for (const User& user : users)
+        sorted.push_back(&user);
+
+    std::sort(sorted.begin(), sorted.end(),
+        [](const User* a, const User* b) { return a->getId() < b->getId(); });
+
+    // Identical strings (dates, shared passwords during migration) are stored once
+    std::string heapData;
+    std::unordered_map<std::string, StringRef> interned;
+
+    auto intern = [&](std::string_view value) {
+        auto found = interned.find(std::string(value));
+        if (found != interned.end())
+            return found->second;
+
+        StringRef ref{ static_cast<uint32_t>(heapData.size()), static_cast<uint32_t>(value.size()) };
+        heapData += value;
+        interned.emplace(value, ref);
+        return ref;
+    };
+
+    std::vector<RecordEntry> table;
+    table.reserve(sorted.size());
+
+    for (const User* user : sorted) {
+        RecordEntry entry{};
+        entry.id = user->getId();
+        entry.username = intern(user->getUsername());
+        entry.password = intern(user->getPassword());
+        entry.email = intern(user->getEmail());
+        entry.createdDate = intern(user->getCreatedDate());
+        table.push_back(entry);
+    }
+
+    FileHeader fileHeader{};
+    std::memcpy(fileHeader.magic, MAGIC, sizeof(MAGIC));
+    fileHeader.version = VERSION;
+    fileHeader.entrySize = sizeof(RecordEntry);
+    fileHeader.recordCount = static_cast<uint32_t>(table.size());
+    fileHeader.entriesOffset = sizeof(FileHeader);
+    fileHeader.heapOffset = fileHeader.entriesOffset + table.size() * sizeof(RecordEntry);
+    fileHeader.heapSize = heapData.size();
+
+    return AtomicFile::replace(path, {
+        { reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader) },
+        { reinterpret_cast<const char*>(table.data()), table.size() * sizeof(RecordEntry) },
+        heapData
+    });
+}
+
+bool UserRecordFile::convertFromCsv(const std::string& csvPath, const std::string& path)
+{
+    std::ifstream in(csvPath);
+    if (!in)
+        return false;
+
+    std::vector<User> users;
+    std::string line;
+
+    while (std::getline(in, line)) {
+        if (line.empty())
+            continue;
+
+        // A row that does not parse fails the whole conversion rather than
+        // quietly leaving that user behind
+        User user = User::fromFileString(line);
+        if (user.getId() <= 0)
+            return false;
+        users.push_back(user);
+    }
+
+    return write(path, users);
+}
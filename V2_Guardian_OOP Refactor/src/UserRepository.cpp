@@ -0,0 +1,538 @@
+#include "../include/UserRepository.h"
+#include "../include/PasswordHasher.h"
+#include <algorithm>
+#include <filesystem>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace {
+
+    // A key the B+-tree cannot hold would leave its user unreachable
+    bool indexable(const User& user)
+    {
+        return user.getUsername().size() <= BPlusTreeIndex::MAX_KEY_LENGTH
+            && user.getEmail().size() <= BPlusTreeIndex::MAX_KEY_LENGTH;
+    }
+
+}
+
+// ==================== Constructor ====================
+
+UserRepository::UserRepository(const std::string& filePath, GroupCommitOptions commitOptions)
+    : filePath(filePath),
+      writer([this](std::vector<Change>& batch, std::vector<char>& accepted) {
+          commitBatch(batch, accepted);
+      }, commitOptions)
+{
+    std::filesystem::path parent = std::filesystem::path(filePath).parent_path();
+    if (!parent.empty())
+        std::filesystem::create_directories(parent);
+
+    std::lock_guard<std::mutex> lock(stateMutex);
+    fileLock.open(std::filesystem::path(filePath).replace_extension(".lock").string());
+    std::lock_guard<FileLock> exclusive(fileLock);
+
+    // Finish or discard whatever a writer that crashed mid-save left behind
+    AtomicFile::recover(filePath, filePath + ".tmp");
+
+    createFileIfNotExists();
+    recordsStamp = AtomicFile::stamp(filePath);
+    openIndexes();
+}
+
+// ==================== CRUD operations ====================
+
+int UserRepository::create(const User& user)
+{
+    if (!indexable(user))
+        return 0;
+
+    int id = 0;
+    return writer.submit(Change{ Change::CREATE, user, std::string(), &id }) ? id : 0;
+}
+
+User* UserRepository::read(const std::string& username) const
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    std::shared_lock<FileLock> shared(fileLock);
+    reloadIfChanged(false);
+
+    size_t index = findRecord(usernameIndex, usernameFilter, username, &UserRecordFile::usernameAt);
+    if (index == UserRecordFile::npos)
+        return nullptr;
+
+    return new User(records.userAt(index));
+}
+
+std::vector<User> UserRepository::getAllUsers() const
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    std::shared_lock<FileLock> shared(fileLock);
+    reloadIfChanged(false);
+    return loadFromFile();
+}
+
+bool UserRepository::update(const User& user)
+{
+    if (!indexable(user))
+        return false;
+
+    return writer.submit(Change{ Change::UPDATE, user, std::string(), nullptr });
+}
+
+bool UserRepository::remove(const std::string& username)
+{
+    return writer.submit(Change{ Change::REMOVE, User(), username, nullptr });
+}
+
+// ==================== Group commit ====================
+
+// Applies the batch in order to one copy of the table, checking each
+// change against the committed indexes plus what earlier changes in the
+// batch did, then saves once. The indexes only change after the save.
+// New users are numbered here, under the file lock, past the largest id
+// on disk and those earlier creates in the batch took.
+void UserRepository::commitBatch(std::vector<Change>& batch, std::vector<char>& accepted)
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    std::lock_guard<FileLock> exclusive(fileLock);
+    reloadIfChanged(true);
+
+    // Never rewrite a file we could not read
+    if (!mapRecords())
+        return;
+
+    std::vector<User> users = loadFromFile();
+    std::vector<char> removed(users.size(), 0);
+
+    // Records are sorted by id, so the last one holds the maximum
+    int32_t nextId = users.empty() ? 1 : users.back().getId() + 1;
+
+    // Keys and ids this batch has touched; 0 marks a key it freed
+    std::unordered_map<std::string, int32_t> usernameOwners;
+    std::unordered_map<std::string, int32_t> emailOwners;
+    std::unordered_map<int32_t, size_t> positions;
+
+    auto ownerOf = [&](const std::unordered_map<std::string, int32_t>& owners,
+        const BPlusTreeIndex& index, const BloomFilter& filter, std::string_view key,
+        std::string_view (UserRecordFile::*field)(size_t) const) -> int32_t {
+        auto it = owners.find(std::string(key));
+        if (it != owners.end())
+            return it->second;
+
+        size_t position = findRecord(index, filter, key, field);
+        return position == UserRecordFile::npos ? 0 : records.idAt(position);
+    };
+
+    auto positionOf = [&](int32_t id) -> size_t {
+        auto it = positions.find(id);
+        size_t position = it != positions.end() ? it->second : records.findById(id);
+        return (position == UserRecordFile::npos || removed[position]) ? UserRecordFile::npos : position;
+    };
+
+    bool changed = false;
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        Change& change = batch[i];
+        const User& user = change.user;
+
+        if (change.kind == Change::CREATE) {
+            if (ownerOf(usernameOwners, usernameIndex, usernameFilter, user.getUsername(), &UserRecordFile::usernameAt) != 0
+                || ownerOf(emailOwners, emailIndex, emailFilter, user.getEmail(), &UserRecordFile::emailAt) != 0)
+                continue;
+
+            change.user.setId(nextId++);
+            positions[user.getId()] = users.size();
+            users.push_back(user);
+            removed.push_back(0);
+        }
+        else if (change.kind == Change::UPDATE) {
+            size_t position = positionOf(user.getId());
+            if (position == UserRecordFile::npos)
+                continue;
+
+            int32_t usernameOwner = ownerOf(usernameOwners, usernameIndex, usernameFilter, user.getUsername(), &UserRecordFile::usernameAt);
+            int32_t emailOwner = ownerOf(emailOwners, emailIndex, emailFilter, user.getEmail(), &UserRecordFile::emailAt);
+            if ((usernameOwner != 0 && usernameOwner != user.getId())
+                || (emailOwner != 0 && emailOwner != user.getId()))
+                continue;
+
+            usernameOwners[std::string(users[position].getUsername())] = 0;
+            emailOwners[std::string(users[position].getEmail())] = 0;
+            users[position] = user;
+        }
+        else {
+            int32_t id = ownerOf(usernameOwners, usernameIndex, usernameFilter, change.username, &UserRecordFile::usernameAt);
+            size_t position = id != 0 ? positionOf(id) : UserRecordFile::npos;
+            if (position == UserRecordFile::npos)
+                continue;
+
+            usernameOwners[change.username] = 0;
+            emailOwners[std::string(users[position].getEmail())] = 0;
+            removed[position] = 1;
+            accepted[i] = 1;
+            changed = true;
+            continue;
+        }
+
+        usernameOwners[std::string(user.getUsername())] = user.getId();
+        emailOwners[std::string(user.getEmail())] = user.getId();
+        accepted[i] = 1;
+        changed = true;
+    }
+
+    if (!changed)
+        return;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < users.size(); ++i) {
+        if (!removed[i])
+            users[kept++] = std::move(users[i]);
+    }
+    users.resize(kept);
+
+    // New keys reach the filters before the data file that holds them, so
+    // a crash can leave a stray bit behind but never miss a stored key
+    for (const auto& [key, id] : usernameOwners) {
+        if (id != 0)
+            usernameFilter.add(key);
+    }
+
+    for (const auto& [key, id] : emailOwners) {
+        if (id != 0)
+            emailFilter.add(key);
+    }
+
+    if (!usernameFilter.flush() || !emailFilter.flush() || !saveToFile(users)) {
+        accepted.assign(accepted.size(), 0);
+        return;
+    }
+
+    recordsStamp = AtomicFile::stamp(filePath);
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (accepted[i] && batch[i].kind == Change::CREATE)
+            *batch[i].createdId = batch[i].user.getId();
+    }
+
+    // Removed and renamed keys still set bits; start afresh once they
+    // have used up the capacity. Otherwise point the filters at the file
+    // just saved; until they are, a reopen rebuilds them.
+    const BloomFilter::Source source = filterSource(users.size());
+    if (usernameFilter.full() || emailFilter.full()
+        || !usernameFilter.setSource(source) || !emailFilter.setSource(source))
+        rebuildFilters(users);
+
+    // A key that fails to erase is harmless: findRecord checks the record
+    // still carries it. One that fails to insert would go missing, so the
+    // indexes are rebuilt from the file just saved. Otherwise their pages
+    // are synced and they are pointed at that file; until they are, a
+    // reopen rebuilds them.
+    bool indexed = true;
+    for (const auto& [key, id] : usernameOwners) {
+        if (id == 0)
+            usernameIndex.erase(key);
+        else
+            indexed = usernameIndex.insert(key, id) && indexed;
+    }
+
+    for (const auto& [key, id] : emailOwners) {
+        if (id == 0)
+            emailIndex.erase(key);
+        else
+            indexed = emailIndex.insert(key, id) && indexed;
+    }
+
+    if (!indexed || !usernameIndex.setSource(recordsStamp) || !emailIndex.setSource(recordsStamp))
+        rebuildIndexes();
+}
+
+// ==================== Indexed lookups ====================
+
+User* UserRepository::readByEmail(const std::string& email) const
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    std::shared_lock<FileLock> shared(fileLock);
+    reloadIfChanged(false);
+
+    size_t index = findRecord(emailIndex, emailFilter, email, &UserRecordFile::emailAt);
+    if (index == UserRecordFile::npos)
+        return nullptr;
+
+    return new User(records.userAt(index));
+}
+
+std::vector<User> UserRepository::findByUsernamePrefix(const std::string& prefix,
+    size_t limit) const
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    std::shared_lock<FileLock> shared(fileLock);
+    reloadIfChanged(false);
+    std::vector<User> users;
+
+    if (!mapRecords())
+        return users;
+
+    for (int32_t id : usernameIndex.prefixScan(prefix, limit)) {
+        size_t index = records.findById(id);
+        if (index != UserRecordFile::npos)
+            users.push_back(records.userAt(index));
+    }
+
+    return users;
+}
+
+// ==================== Streaming scan ====================
+
+UserCursor UserRepository::cursor(unsigned fields, UserCursor::Filter filter,
+    size_t batchSize) const
+{
+    return UserCursor(filePath, fields, std::move(filter), batchSize);
+}
+
+// ==================== Helper methods ====================
+
+bool UserRepository::exists(std::string_view username) const
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    std::shared_lock<FileLock> shared(fileLock);
+    reloadIfChanged(false);
+    return findRecord(usernameIndex, usernameFilter, username, &UserRecordFile::usernameAt) != UserRecordFile::npos;
+}
+
+bool UserRepository::emailExists(std::string_view email) const
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    std::shared_lock<FileLock> shared(fileLock);
+    reloadIfChanged(false);
+    return findRecord(emailIndex, emailFilter, email, &UserRecordFile::emailAt) != UserRecordFile::npos;
+}
+
+int UserRepository::count() const
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    std::shared_lock<FileLock> shared(fileLock);
+    reloadIfChanged(false);
+    return mapRecords() ? static_cast<int>(records.size()) : 0;
+}
+
+int UserRepository::getNextId() const
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    std::shared_lock<FileLock> shared(fileLock);
+    reloadIfChanged(false);
+
+    // Records are sorted by id, so the last one holds the maximum
+    if (!mapRecords() || records.size() == 0)
+        return 1;
+
+    return records.idAt(records.size() - 1) + 1;
+}
+
+// ==================== Authentication helper ====================
+
+bool UserRepository::validateCredentials(const std::string& username,
+    const std::string& password) const
+{
+    std::string stored;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        std::shared_lock<FileLock> shared(fileLock);
+        reloadIfChanged(false);
+
+        size_t index = findRecord(usernameIndex, usernameFilter, username, &UserRecordFile::usernameAt);
+        if (index == UserRecordFile::npos)
+            return false;
+
+        stored = records.passwordAt(index);
+    }
+
+    // Verification is deliberately slow, so it runs outside the lock
+    return PasswordHasher::verify(password, stored);
+}
+
+// ==================== Cross-process coherence ====================
+
+// Another instance saved since we last looked: the data file is a new
+// one and the indexes were updated in place, so drop every cached view
+// of them. Only the writer may rebuild indexes a crash left behind.
+void UserRepository::reloadIfChanged(bool writer) const
+{
+    AtomicFile::Stamp current = AtomicFile::stamp(filePath);
+    if (current == recordsStamp)
+        return;
+
+    records.close();
+    recordsStamp = current;
+
+    if (writer) {
+        openIndexes();
+    }
+    else {
+        usernameIndex.open(indexPath("username"));
+        emailIndex.open(indexPath("email"));
+        usernameFilter.open(filterPath("username"));
+        emailFilter.open(filterPath("email"));
+
+        // A stale filter would miss stored keys; closed, it answers "maybe"
+        const BloomFilter::Source source = filterSource(mapRecords() ? records.size() : 0);
+        if (!usernameFilter.builtFrom(source))
+            usernameFilter.close();
+        if (!emailFilter.builtFrom(source))
+            emailFilter.close();
+    }
+}
+
+// ==================== I/O helpers ====================
+
+std::vector<User> UserRepository::loadFromFile() const
+{
+    std::vector<User> users;
+
+    if (!mapRecords())
+        return users;
+
+    users.reserve(records.size());
+    for (size_t i = 0; i < records.size(); ++i)
+        users.push_back(records.userAt(i));
+
+    return users;
+}
+
+bool UserRepository::saveToFile(const std::vector<User>& users) const
+{
+    // Windows cannot replace a file that is still mapped
+    records.close();
+    return UserRecordFile::write(filePath, users);
+}
+
+// ==================== File utilities ====================
+
+bool UserRepository::fileExists() const
+{
+    return std::filesystem::exists(filePath);
+}
+
+void UserRepository::createFileIfNotExists() const
+{
+    if (fileExists())
+        return;
+
+    // A legacy file that fails to convert is kept and no data file is
+    // created, so writes are refused instead of starting over without it
+    const std::string legacy = legacyCsvPath();
+    if (legacy != filePath && std::filesystem::exists(legacy)) {
+        UserRecordFile::convertFromCsv(legacy, filePath);
+        return;
+    }
+
+    UserRecordFile::write(filePath, {});
+}
+
+bool UserRepository::mapRecords() const
+{
+    return records.isOpen() || records.open(filePath);
+}
+
+std::string UserRepository::legacyCsvPath() const
+{
+    return std::filesystem::path(filePath).replace_extension(".txt").string();
+}
+
+// ==================== Index utilities ====================
+
+void UserRepository::openIndexes() const
+{
+    usernameIndex.open(indexPath("username"));
+    emailIndex.open(indexPath("email"));
+
+    // A crash between saving the data file and syncing an index leaves
+    // the index describing an older file; the data file is the source of truth.
+    if (!usernameIndex.builtFrom(recordsStamp) || !emailIndex.builtFrom(recordsStamp))
+        rebuildIndexes();
+
+    openFilters();
+}
+
+bool UserRepository::rebuildIndexes() const
+{
+    if (!mapRecords())
+        return false;
+
+    std::vector<std::pair<std::string, int32_t>> usernames;
+    std::vector<std::pair<std::string, int32_t>> emails;
+    usernames.reserve(records.size());
+    emails.reserve(records.size());
+
+    for (size_t i = 0; i < records.size(); ++i) {
+        usernames.emplace_back(std::string(records.usernameAt(i)), records.idAt(i));
+        emails.emplace_back(std::string(records.emailAt(i)), records.idAt(i));
+    }
+
+    return usernameIndex.rebuild(std::move(usernames), recordsStamp)
+        && emailIndex.rebuild(std::move(emails), recordsStamp);
+}
+
+std::string UserRepository::indexPath(const std::string& field) const
+{
+    return std::filesystem::path(filePath).replace_extension("." + field + ".idx").string();
+}
+
+size_t UserRepository::findRecord(const BPlusTreeIndex& index, const BloomFilter& filter,
+    std::string_view key, std::string_view (UserRecordFile::*field)(size_t) const) const
+{
+    if (!filter.mayContain(key) || !mapRecords())
+        return UserRecordFile::npos;
+
+    int32_t id;
+    if (!index.find(key, id))
+        return UserRecordFile::npos;
+
+    // Check the record still carries the key in case the index is stale
+    size_t position = records.findById(id);
+    if (position == UserRecordFile::npos || (records.*field)(position) != key)
+        return UserRecordFile::npos;
+
+    return position;
+}
+
+// ==================== Filter utilities ====================
+
+void UserRepository::openFilters() const
+{
+    // Missing (first run, or written by an older build), damaged, or
+    // built from another data file than the one now on disk
+    const BloomFilter::Source source = filterSource(mapRecords() ? records.size() : 0);
+    if (!usernameFilter.open(filterPath("username")) || !emailFilter.open(filterPath("email"))
+        || !usernameFilter.builtFrom(source) || !emailFilter.builtFrom(source))
+        rebuildFilters(loadFromFile());
+}
+
+bool UserRepository::rebuildFilters(const std::vector<User>& users) const
+{
+    std::vector<std::string_view> usernames;
+    std::vector<std::string_view> emails;
+    usernames.reserve(users.size());
+    emails.reserve(users.size());
+
+    for (const User& user : users) {
+        usernames.push_back(user.getUsername());
+        emails.push_back(user.getEmail());
+    }
+
+    // Room to double before the next rebuild
+    const size_t capacity = std::max<size_t>(1024, users.size() * 2);
+    const BloomFilter::Source source = filterSource(users.size());
+    return usernameFilter.rebuild(filterPath("username"), usernames, capacity, source)
+        && emailFilter.rebuild(filterPath("email"), emails, capacity, source);
+}
+
+BloomFilter::Source UserRepository::filterSource(size_t recordCount) const
+{
+    return BloomFilter::Source{ recordCount, recordsStamp };
+}
+
+std::string UserRepository::filterPath(const std::string& field) const
+{
+    return std::filesystem::path(filePath).replace_extension("." + field + ".bloom").string();
+}
@@ -0,0 +1,132 @@
+#include "../include/Validator.h"
+#include "../include/CharClass.h"
+
+// Character checks go through the CharClass kernels: ASCII-only, so the
+// same answers as <cctype> in the "C" locale, vectorized where supported.
+
+// ==================== Username validations ====================
+
+// 3-20 chars, starts with a letter, letters/digits/underscore only
+bool Validator::isValidUsername(std::string_view username)
+{
+    if (!isUsernameLength(username))
+        return false;
+
+    if (!(CharClass::classOf(username[0]) & CharClass::ALPHA))
+        return false;
+
+    return CharClass::findFirstNotIn(username.data(), username.size(),
+        CharClass::ALNUM | CharClass::UNDERSCORE) == username.size();
+}
+
+bool Validator::isUsernameLength(std::string_view username)
+{
+    return isLengthInRange(username, 3, 20);
+}
+
+bool Validator::hasNoSpaces(std::string_view username)
+{
+    return !(CharClass::classesPresent(username.data(), username.size()) & CharClass::SPACE);
+}
+
+// ==================== Password validations ====================
+
+bool Validator::isValidPassword(std::string_view password)
+{
+    return isLengthInRange(password, 8, 50) && isPasswordStrong(password);
+}
+
+// Needs upper, lower, digit and special character; no whitespace
+bool Validator::isPasswordStrong(std::string_view password)
+{
+    uint8_t present = CharClass::classesPresent(password.data(), password.size());
+
+    const uint8_t special = CharClass::UNDERSCORE | CharClass::DOT_DASH | CharClass::OTHER;
+
+    return !(present & CharClass::SPACE)
+        && (present & CharClass::UPPER)
+        && (present & CharClass::LOWER)
+        && (present & CharClass::DIGIT)
+        && (present & special);
+}
+
+// ==================== Email validations ====================
+
+bool Validator::isValidEmail(std::string_view email)
+{
+    if (isEmpty(email) || email.length() > 100 || !hasAtSymbol(email))
+        return false;
+
+    size_t atPos = email.find('@');
+    if (atPos == 0)
+        return false;
+
+    size_t dotPos = email.find('.', atPos);
+    if (dotPos == std::string_view::npos || dotPos == atPos + 1 || dotPos == email.length() - 1)
+        return false;
+
+    if (email.find(' ') != std::string_view::npos)
+        return false;
+
+    return CharClass::findFirstNotIn(email.data(), atPos,
+        CharClass::ALNUM | CharClass::UNDERSCORE | CharClass::DOT_DASH) == atPos;
+}
+
+bool Validator::hasAtSymbol(std::string_view email)
+{
+    return email.find('@') != std::string_view::npos;
+}
+
+// ==================== Helper methods ====================
+
+bool Validator::isEmpty(std::string_view str)
+{
+    return str.empty();
+}
+
+bool Validator::isLengthInRange(std::string_view str, int min, int max)
+{
+    return static_cast<int>(str.length()) >= min && static_cast<int>(str.length()) <= max;
+}
+
+bool Validator::containsOnlyAlphanumeric(std::string_view str)
+{
+    return CharClass::findFirstNotIn(str.data(), str.size(), CharClass::ALNUM) == str.size();
+}
+
+// ==================== Batch validation ====================
+
+size_t Validator::validateColumn(Field field, const std::vector<std::string_view>& values,
+    std::vector<uint8_t>& valid)
+{
+    bool (*check)(std::string_view) = field == Field::USERNAME ? isValidUsername
+        : field == Field::PASSWORD ? isValidPassword
+        : isValidEmail;
+
+    valid.resize(values.size());
+
+    size_t validCount = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        valid[i] = check(values[i]) ? 1 : 0;
+        validCount += valid[i];
+    }
+
+    return validCount;
+}
+
+// ==================== Display validation errors ====================
+
+std::string Validator::getValidationErrors(const std::string& field,
+    const std::string& value)
+{
+    if (field == "username" && !isValidUsername(value))
+        return "Username must be 3-20 chars, start with a letter, alphanumeric + underscore";
+
+    if (field == "password" && !isValidPassword(value))
+        return "Password needs 8-50 chars, uppercase, lowercase, digit, special char, no spaces";
+
+    if (field == "email" && !isValidEmail(value))
+        return "Email must look like valid@email.com, max 100 characters";
+
+    return "";
+}
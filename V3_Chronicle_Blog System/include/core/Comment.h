@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// A comment on a post, or a reply to another comment. Ids are small
+// integers like post ids; parentId is 0 for a top-level comment.
+class Comment {
+private:
+    int id;
+    int postId;
+    int authorId;
+    int parentId;
+    std::string content;
+    int64_t createdAt;
+
+public:
+    // Constructors
+    Comment();
+    Comment(int id, int postId, int authorId, int parentId, std::string_view content);
+    Comment(int id, int postId, int authorId, int parentId, std::string_view content,
+        int64_t createdAt); // Restore persisted comment
+
+    // Getters
+    int getId() const { return id; }
+    int getPostId() const { return postId; }
+    int getAuthorId() const { return authorId; }
+    int getParentId() const { return parentId; }
+    const std::string& getContent() const { return content; }
+    int64_t getCreatedAt() const { return createdAt; }
+    bool isReply() const { return parentId != 0; }
+
+    // Editing
+    void edit(std::string_view newContent);
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// A blog post. Ids are small integers handed out by whoever stores posts,
+// so the search and analytics structures can key on them directly; times
+// are Timestamp second counts.
+class Post {
+private:
+    int id;
+    int authorId;
+    std::string title;
+    std::string content;
+    int64_t createdAt;
+    int64_t updatedAt;
+
+public:
+    // Constructors
+    Post();
+    Post(int id, int authorId, std::string_view title, std::string_view content);
+    Post(int id, int authorId, std::string_view title, std::string_view content,
+        int64_t createdAt, int64_t updatedAt); // Restore persisted post
+
+    // Getters
+    int getId() const { return id; }
+    int getAuthorId() const { return authorId; }
+    const std::string& getTitle() const { return title; }
+    const std::string& getContent() const { return content; }
+    int64_t getCreatedAt() const { return createdAt; }
+    int64_t getUpdatedAt() const { return updatedAt; }
+
+    // Editing
+    void edit(std::string_view newTitle, std::string_view newContent);
+};
@@ -0,0 +1,8 @@
+#pragma once
+
+// Reader interactions with a post, as counted for trending
+enum class EngagementType {
+    VIEW,
+    LIKE,
+    COMMENT
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include "../core/Comment.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+struct CommentRow {
+    const Comment* comment; // valid until the thread next changes
+    uint32_t depth;         // 0 for top-level comments
+    uint32_t replies;       // the whole subtree below it
+};
+
+// All comments of one post, stored flat in display order.
+//
+// The thread is kept in pre-order - each comment followed by its replies,
+// oldest first, recursively - with a depth per row. A comment's subtree
+// is then the descendants() rows straight after it (the nested-set
+// encoding), so rendering a thread, a page of it or one sub-thread is a
+// single forward scan with no pointers to chase, and a page is found by
+// position, not by walking everything before it.
+//
+// The order is split into blocks of at most BLOCK_SIZE rows with a
+// running count of rows before each block. A reply goes in right after
+// its parent's existing subtree: that touches one block (split in two
+// when full), the counts after it and the reply's ancestors, never the
+// whole array. Comments themselves sit in an append-only table the rows
+// refer to by index. Not thread-safe: callers serialize access per post,
+// as they do for the Post itself.
+class CommentThread {
+public:
+    static constexpr size_t BLOCK_SIZE = 512;
+
+public:
+    CommentThread() = default;
+
+    CommentThread(const CommentThread&) = delete;
+    CommentThread& operator=(const CommentThread&) = delete;
+
+    // Adds a comment, or a reply after its parent's other replies. False
+    // for a duplicate id or a reply to a comment not in the thread.
+    bool add(const Comment& comment);
+
+    const Comment* find(int commentId) const;
+    size_t size() const { return comments.size(); }
+    size_t replyCount(int commentId) const; // the whole subtree
+
+    // Display order, count rows from offset
+    std::vector<CommentRow> page(size_t offset, size_t count) const;
+    // A comment followed by its replies, count rows from offset within that
+    std::vector<CommentRow> subtree(int commentId, size_t offset, size_t count) const;
+
+private:
+    struct Row {
+        uint32_t comment; // index into comments
+        uint32_t depth;
+    };
+
+    struct Block {
+        std::vector<Row> rows;
+        size_t order; // position in blockOrder
+    };
+
+    // Where a row is: block position in blockOrder and index within it
+    struct Place {
+        size_t block;
+        size_t index;
+    };
+
+    size_t positionOf(uint32_t comment) const;
+    Place placeAt(size_t position) const;
+    void insertAt(size_t position, Row row);
+    void split(size_t order);
+    std::vector<CommentRow> rows(size_t position, size_t count) const;
+
+    std::vector<Comment> comments;            // append-only
+    std::unordered_map<int, uint32_t> indexOf; // comment id -> index
+    std::vector<uint32_t> parents;            // by index; UINT32_MAX at top level
+    std::vector<uint32_t> descendants;        // by index
+    std::vector<uint32_t> blockOf;            // by index, stable block id
+
+    std::vector<std::unique_ptr<Block>> blocks; // by stable id
+    std::vector<uint32_t> blockOrder;           // block ids in display order
+    std::vector<size_t> rowsBefore;             // by position in blockOrder
+};
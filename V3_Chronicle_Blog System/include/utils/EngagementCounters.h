@@ -0,0 +1,131 @@
+#pragma once
+#include "RoaringBitmap.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct EngagementOptions {
+    // How often pending views are folded into the totals and everything
+    // is handed to storage. Zero starts no flusher thread: call flush().
+    std::chrono::milliseconds flushInterval{ 1000 };
+};
+
+// View counts and likes for every post: what the design's
+// Post::incrementViews(), like() and unlike() keep on each post, held in
+// one place instead.
+//
+// A view only bumps a counter in the calling thread's stripe (one cache
+// line and lock per stripe, threads spread over VIEW_STRIPES), so views
+// of a popular post from many threads do not fight over one counter.
+// flush() drains the stripes into the totals that views() reports, which
+// therefore lag by up to one flush interval.
+//
+// Likes are exact at once: each post keeps its likers' user ids in a
+// RoaringBitmap, so like, unlike and hasLiked are a bit test rather than
+// a scan of a liker list, and a like is never counted twice.
+//
+// Each flush collects the view deltas and the like changes since the last
+// one into a Batch for the Flush function to persist in one go; journal()
+// is one that appends them to a file and syncs it, restore() replays that
+// file and compact() rewrites it as just the current totals and each
+// post's serialized liker bitmap. A batch that fails to persist is
+// retried, merged into the next one, so a Flush that returns false must
+// leave nothing of it behind.
+class EngagementCounters {
+public:
+    static constexpr size_t VIEW_STRIPES = 16;
+    static constexpr size_t LIKE_STRIPES = 64;
+
+    struct ViewDelta {
+        int postId;
+        uint64_t views;
+    };
+
+    struct LikeChange {
+        int postId;
+        uint32_t userId;
+        bool liked; // false: unliked
+    };
+
+    struct Batch {
+        std::vector<ViewDelta> views;
+        std::vector<LikeChange> likes; // in order for each post
+
+        bool empty() const { return views.empty() && likes.empty(); }
+    };
+
+    // Persists a batch; returning false keeps it for the next flush, so it
+    // must not have stored any of it
+    using Flush = std::function<bool(const Batch& batch)>;
+
+public:
+    explicit EngagementCounters(Flush flush = Flush(), EngagementOptions options = EngagementOptions());
+    ~EngagementCounters(); // flushes whatever is pending
+
+    EngagementCounters(const EngagementCounters&) = delete;
+    EngagementCounters& operator=(const EngagementCounters&) = delete;
+
+    // Views
+    void recordView(int postId);
+    uint64_t views(int postId) const; // as of the last flush
+
+    // Likes - false when nothing changed
+    bool like(int postId, uint32_t userId);
+    bool unlike(int postId, uint32_t userId);
+    bool hasLiked(int postId, uint32_t userId) const;
+    size_t likeCount(int postId) const;
+
+    // Storage
+    bool flush();
+    bool restore(const std::string& path); // replay a journal, before any events
+    bool compact(const std::string& path);  // the journal flush() appends to
+    static Flush journal(const std::string& path);
+
+private:
+    // One cache line apiece, so neighbouring stripes do not share one
+    struct alignas(64) ViewStripe {
+        std::mutex mutex;
+        std::unordered_map<int, uint64_t> pending;
+    };
+
+    struct alignas(64) LikeStripe {
+        mutable std::mutex mutex;
+        std::unordered_map<int, RoaringBitmap> likers;
+        std::vector<LikeChange> changes; // since the last flush
+    };
+
+    ViewStripe& viewStripe();
+    LikeStripe& likeStripe(int postId) const;
+    bool apply(const LikeChange& change, bool logged);
+    bool flushLocked();
+    void flusherLoop();
+
+    Flush persist;
+    EngagementOptions options;
+
+    std::unique_ptr<ViewStripe[]> viewStripes;
+    std::unique_ptr<LikeStripe[]> likeStripes;
+
+    std::unordered_map<int, uint64_t> totals;
+    mutable std::shared_mutex totalsMutex;
+
+    // Drained but not yet persisted
+    std::unordered_map<int, uint64_t> unflushedViews;
+    std::vector<LikeChange> unflushedLikes;
+    std::mutex flushMutex; // one flush at a time
+
+    std::mutex stopMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    std::thread flusher; // last: starts once everything above exists
+};
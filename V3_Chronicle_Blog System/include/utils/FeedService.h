@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+struct FeedOptions {
+    size_t inboxCapacity = 1000;  // newest posts kept per reader
+    size_t authorHistory = 1000;  // newest posts kept per author
+    size_t pullThreshold = 10000; // followers beyond which an author is pulled
+};
+
+struct FeedItem {
+    int postId;
+    int authorId;
+    uint64_t sequence; // publish order, newest highest
+};
+
+struct FeedPage {
+    std::vector<FeedItem> items; // newest first
+    uint64_t nextCursor = 0;     // pass back for the next page; 0 when done
+};
+
+// Home feeds: the posts of everyone a user follows, newest first.
+//
+// Hybrid fan-out. Publishing pushes the post into a bounded ring - the
+// inbox - of each follower, so a typical feed read is a walk down one
+// array. Pushing stops paying once an author has more than pullThreshold
+// followers: from then on that author is pulled instead, and a read
+// merges the reader's inbox with the recent posts of each pulled author
+// they follow through a heap. Few authors are that popular, so a read
+// costs O(page size) plus a heap of a handful of sources.
+//
+// The switch to pulling is one-way; posts already pushed to inboxes are
+// passed over once the author's own history supplies them. Following an
+// author back-fills the inbox with their recent posts and unfollowing
+// purges them. Thread-safe: reads run concurrently, everything else
+// exclusively.
+class FeedService {
+public:
+    explicit FeedService(FeedOptions options = FeedOptions());
+
+    FeedService(const FeedService&) = delete;
+    FeedService& operator=(const FeedService&) = delete;
+
+    // Follows graph - false when nothing changed
+    bool follow(int followerId, int authorId);
+    bool unfollow(int followerId, int authorId);
+    size_t followerCount(int authorId) const;
+    bool isPulled(int authorId) const;
+
+    // Posts - returns the post's sequence
+    uint64_t publish(int authorId, int postId);
+
+    // One page of a user's feed, starting after cursor (0: the newest)
+    FeedPage feed(int userId, size_t pageSize, uint64_t cursor = 0) const;
+
+private:
+    // Newest-first view over a fixed-capacity circular buffer
+    class Ring {
+    public:
+        size_t size() const { return items.size(); }
+        const FeedItem& newest(size_t i) const {
+            return items[(next + items.size() - 1 - i) % items.size()];
+        }
+
+        void push(const FeedItem& item, size_t capacity);
+        void assign(const std::vector<FeedItem>& newestFirst);
+        size_t firstBefore(uint64_t cursor) const; // first item older than cursor
+
+    private:
+        std::vector<FeedItem> items;
+        size_t next = 0; // oldest item, overwritten next, once full
+    };
+
+    struct Author {
+        std::unordered_set<int> followers;
+        Ring history;
+        bool pulled = false;
+    };
+
+    struct Reader {
+        std::unordered_set<int> following;
+        std::vector<int> pulledFollowing;
+        Ring inbox;
+    };
+
+    void backfill(Reader& reader, const Author& author);
+    void purge(Reader& reader, int authorId);
+    void startPulling(Author& author, int authorId);
+
+    FeedOptions options;
+    std::unordered_map<int, Author> authors;
+    std::unordered_map<int, Reader> readers;
+    uint64_t lastSequence = 0;
+
+    mutable std::shared_mutex mutex;
+};
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Compressed set of 32-bit ids (roaring bitmap).
+//
+// Ids are split by their high 16 bits into containers of up to 65536. A
+// container holds a sorted array of low halves while it has at most
+// ARRAY_LIMIT of them (2 bytes an id) and a plain 8 KB bitmap once it is
+// denser, so small sets stay small and big ones cost one bit an id.
+// Lookups find the container with a binary search over the handful of
+// high halves in use, then do a bit test or a search of at most
+// ARRAY_LIMIT entries.
+class RoaringBitmap {
+public:
+    static constexpr size_t ARRAY_LIMIT = 4096;
+
+public:
+    bool add(uint32_t id);    // false if already present
+    bool remove(uint32_t id); // false if absent
+    bool contains(uint32_t id) const;
+
+    size_t size() const { return cardinality; }
+    bool empty() const { return cardinality == 0; }
+
+    // Every id in ascending order
+    template <typename Callback>
+    void forEach(Callback&& callback) const;
+
+    // Portable encoding, what EngagementCounters::compact() stores;
+    // deserialize() fails on damaged input
+    std::string serialize() const;
+    bool deserialize(std::string_view data);
+
+private:
+    static constexpr size_t BITMAP_WORDS = 65536 / 64;
+
+    struct Container {
+        uint16_t key;                // high 16 bits shared by its ids
+        uint32_t count = 0;
+        std::vector<uint16_t> array; // sorted, while count <= ARRAY_LIMIT
+        std::vector<uint64_t> bits;  // BITMAP_WORDS words, once denser
+
+        bool isBitmap() const { return !bits.empty(); }
+    };
+
+    const Container* find(uint16_t key) const;
+
+    static unsigned lowestSetBit(uint64_t bits);
+    static void toBitmap(Container& container);
+    static void toArray(Container& container);
+
+    std::vector<Container> containers; // sorted by key
+    size_t cardinality = 0;
+};
+
+// ==================== Iteration ====================
+
+template <typename Callback>
+void RoaringBitmap::forEach(Callback&& callback) const
+{
+    for (const Container& container : containers) {
+        const uint32_t high = static_cast<uint32_t>(container.key) << 16;
+
+        if (!container.isBitmap()) {
+            for (uint16_t low : container.array)
+                callback(high | low);
+            continue;
+        }
+
+        for (size_t word = 0; word < BITMAP_WORDS; ++word) {
+            for (uint64_t bits = container.bits[word]; bits != 0; bits &= bits - 1)
+                callback(high | static_cast<uint32_t>(word * 64 + lowestSetBit(bits)));
+        }
+    }
+}
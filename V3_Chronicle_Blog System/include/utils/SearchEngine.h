@@ -0,0 +1,116 @@
+#pragma once
+#include "../core/Post.h"
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct SearchResult {
+    int postId;
+    double score;
+};
+
+// Full-text search over post titles and contents.
+//
+// An in-memory inverted index: every term has one posting list holding,
+// for each post containing it, the post's document number and how often
+// the term occurs in its title and its content. Postings are delta and
+// varint encoded, usually two bytes each, and every BLOCK_SIZE of them
+// start a skip entry, so intersecting a rare term with a common one
+// jumps over whole blocks instead of decoding them.
+//
+// Queries are conjunctive: a post matches when it contains every query
+// term (in the searched field). Matches are ranked with BM25 - BM25F over
+// both fields for search(), title words counting TITLE_WEIGHT times - and
+// only the best limit are kept, in a heap.
+//
+// indexPost() appends to the lists, so indexing stays incremental. A
+// re-indexed or removed post leaves dead postings behind, skipped at
+// query time; rebuildIndex() squeezes them out. Thread-safe: searches run
+// concurrently, updates exclusively.
+class SearchEngine {
+public:
+    static constexpr size_t BLOCK_SIZE = 128;     // postings per skip entry
+    static constexpr size_t MAX_TERM_LENGTH = 64; // longer words are not indexed
+    static constexpr double TITLE_WEIGHT = 2.0;
+
+    struct Stats {
+        size_t posts = 0;        // searchable
+        size_t documents = 0;    // including dead ones awaiting rebuildIndex()
+        size_t terms = 0;
+        size_t postings = 0;
+        size_t postingBytes = 0; // encoded posting lists
+        size_t indexBytes = 0;   // postings, skips, vocabulary and document table
+    };
+
+public:
+    SearchEngine() = default;
+
+    SearchEngine(const SearchEngine&) = delete;
+    SearchEngine& operator=(const SearchEngine&) = delete;
+
+    // Indexing - indexPost() replaces an earlier version of the same post
+    void indexPost(const Post& post);
+    bool removePost(int postId);
+    void rebuildIndex();
+
+    // Ranked retrieval, best first
+    std::vector<SearchResult> search(std::string_view query, size_t limit = 10) const;
+    std::vector<SearchResult> searchByTitle(std::string_view query, size_t limit = 10) const;
+    std::vector<SearchResult> searchByContent(std::string_view query, size_t limit = 10) const;
+
+    Stats stats() const;
+
+    // Lower-cased words of text with stop words dropped, as indexed
+    static std::vector<std::string> tokenize(std::string_view text);
+
+private:
+    enum class Field { ALL, TITLE, CONTENT };
+
+    struct Skip {
+        uint32_t lastDocument; // last document number in the block
+        uint32_t baseDocument; // the one before the block, deltas start from it
+        uint32_t offset;       // first byte of the block
+    };
+
+    struct PostingList {
+        std::vector<uint8_t> bytes;
+        std::vector<Skip> skips;
+        uint32_t count = 0;
+    };
+
+    struct Document {
+        int postId;
+        uint32_t titleLength;   // terms indexed
+        uint32_t contentLength;
+        bool removed;
+    };
+
+    class Cursor;
+
+    // Indexing helpers
+    void addDocument(const Post& post);
+    void removeDocument(uint32_t document);
+    static void append(PostingList& list, uint32_t document, uint32_t titleFrequency,
+        uint32_t contentFrequency);
+
+    // Query helpers
+    std::vector<SearchResult> query(std::string_view text, size_t limit, Field field) const;
+
+    template <typename Callback>
+    static void forEachTerm(std::string_view text, std::string& buffer, Callback&& callback);
+    static bool isStopWord(std::string_view term);
+
+    std::unordered_map<std::string, uint32_t> termIds;
+    std::vector<PostingList> postings;            // by term id
+    std::vector<Document> documents;              // by document number
+    std::unordered_map<int, uint32_t> documentOf; // post id -> live document
+
+    uint64_t titleLengthTotal = 0;                // over live documents
+    uint64_t contentLengthTotal = 0;
+
+    mutable std::shared_mutex mutex;
+};
@@ -0,0 +1,115 @@
+#pragma once
+#include "../enums/EngagementType.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+struct TrendingOptions {
+    double halfLifeSeconds = 6 * 3600; // an event's weight halves this often
+    int64_t windowSeconds = 0;         // > 0: rank by events in the last windowSeconds instead
+    int64_t bucketSeconds = 3600;      // how finely the window slides
+    size_t maxResults = 100;           // longest list trending() and recent() serve
+};
+
+struct TrendingEntry {
+    int postId;
+    double score; // decayed to the latest event, or summed over the window
+};
+
+// Streaming trending and recent-post rankings for BlogManager.
+//
+// Views, likes and comments add weighted points to a post (the README's
+// engagement weights: 1, 10 and 5). By default points decay
+// exponentially. Scores are kept as log2 of the points scaled up to a
+// fixed landmark ("forward decay"), so decaying never changes how two
+// posts compare and an ordered set stays sorted without ever being
+// revisited: an event is one O(log n) erase and insert. With a window
+// instead, events are bucketed by time and a bucket's points are taken
+// back out when it slides past.
+//
+// Readers get a snapshot of the top maxResults published with an atomic
+// pointer swap, so trending() and recent() are O(k) copies that never wait
+// on writers: a stale snapshot is rebuilt only if the lock is free at
+// that moment, otherwise the previous one is served. Writers republish
+// every REPUBLISH_EVENTS updates themselves, so a steady stream of events
+// cannot keep readers on an old list.
+class TrendingTracker {
+public:
+    static constexpr uint64_t REPUBLISH_EVENTS = 256;
+
+public:
+    explicit TrendingTracker(TrendingOptions options = TrendingOptions());
+
+    TrendingTracker(const TrendingTracker&) = delete;
+    TrendingTracker& operator=(const TrendingTracker&) = delete;
+
+    // Posts - events for posts never added are ignored
+    void addPost(int postId, int64_t createdAt);
+    bool removePost(int postId);
+
+    // Events - at is a Timestamp second count; arrival order does not matter
+    bool record(int postId, EngagementType type, int64_t at);
+    bool record(int postId, EngagementType type);
+    void advance(int64_t now); // slides the window when no events arrive
+
+    // Rankings, best or newest first
+    std::vector<TrendingEntry> trending(size_t count) const;
+    std::vector<int> recent(size_t count) const;
+
+    static double weight(EngagementType type);
+
+private:
+    struct Key {
+        double score;
+        int64_t tieBreak; // creation time
+        int postId;
+
+        bool operator<(const Key& other) const {
+            // Best first; ties go to the newer post
+            if (score != other.score)
+                return score > other.score;
+            if (tieBreak != other.tieBreak)
+                return tieBreak > other.tieBreak;
+            return postId > other.postId;
+        }
+    };
+
+    struct Entry {
+        double score; // log2 points at the landmark, or window points
+        int64_t createdAt;
+    };
+
+    struct Snapshot {
+        uint64_t version = 0;
+        std::vector<TrendingEntry> trending;
+        std::vector<int> recent;
+    };
+
+    bool windowed() const { return options.windowSeconds > 0; }
+    void setScore(int postId, Entry& entry, double score);
+    void expireBuckets(int64_t bucket);
+    void changed();
+    std::shared_ptr<const Snapshot> publish() const;
+    std::shared_ptr<const Snapshot> current() const;
+
+    TrendingOptions options;
+
+    std::unordered_map<int, Entry> posts;
+    std::set<Key> byScore;
+    std::set<Key> byCreation;
+    int64_t latest = 0; // newest event time seen
+
+    // Window mode: points per post per bucket, oldest slot reused first
+    std::vector<std::unordered_map<int, double>> buckets;
+    int64_t headBucket = 0; // bucket number of the newest slot
+
+    mutable std::mutex mutex;
+    std::atomic<uint64_t> version{ 0 };
+    mutable uint64_t publishedVersion = 0;
+    mutable std::shared_ptr<const Snapshot> snapshot; // atomic_load / atomic_store only
+};
@@ -0,0 +1,29 @@
+#include "../../include/core/Comment.h"
+#include "../../../V2_Guardian_OOP Refactor/include/Timestamp.h"
+
+// ==================== Constructors ====================
+
+Comment::Comment()
+    : id(0), postId(0), authorId(0), parentId(0), createdAt(0)
+{
+}
+
+Comment::Comment(int id, int postId, int authorId, int parentId, std::string_view content)
+    : id(id), postId(postId), authorId(authorId), parentId(parentId), content(content),
+      createdAt(Timestamp::now())
+{
+}
+
+Comment::Comment(int id, int postId, int authorId, int parentId, std::string_view content,
+    int64_t createdAt)
+    : id(id), postId(postId), authorId(authorId), parentId(parentId), content(content),
+      createdAt(createdAt)
+{
+}
+
+// ==================== Editing ====================
+
+void Comment::edit(std::string_view newContent)
+{
+    content = newContent;
+}
@@ -0,0 +1,31 @@
+#include "../../include/core/Post.h"
+#include "../../../V2_Guardian_OOP Refactor/include/Timestamp.h"
+
+// ==================== Constructors ====================
+
+Post::Post()
+    : id(0), authorId(0), createdAt(0), updatedAt(0)
+{
+}
+
+Post::Post(int id, int authorId, std::string_view title, std::string_view content)
+    : id(id), authorId(authorId), title(title), content(content),
+      createdAt(Timestamp::now()), updatedAt(createdAt)
+{
+}
+
+Post::Post(int id, int authorId, std::string_view title, std::string_view content,
+    int64_t createdAt, int64_t updatedAt)
+    : id(id), authorId(authorId), title(title), content(content),
+      createdAt(createdAt), updatedAt(updatedAt)
+{
+}
+
+// ==================== Editing ====================
+
+void Post::edit(std::string_view newTitle, std::string_view newContent)
+{
+    title = newTitle;
+    content = newContent;
+    updatedAt = Timestamp::now();
+}
@@ -0,0 +1,176 @@
+#include "../../include/utils/CommentThread.h"
+#include <algorithm>
+
+namespace {
+
+    const uint32_t NO_PARENT = UINT32_MAX;
+
+}
+
+// ==================== Adding ====================
+
+bool CommentThread::add(const Comment& comment)
+{
+    if (indexOf.count(comment.getId()) > 0)
+        return false;
+
+    uint32_t parent = NO_PARENT;
+    size_t position = comments.size();
+    uint32_t depth = 0;
+
+    if (comment.isReply()) {
+        auto it = indexOf.find(comment.getParentId());
+        if (it == indexOf.end())
+            return false;
+
+        parent = it->second;
+        const size_t parentPosition = positionOf(parent);
+        const Place place = placeAt(parentPosition);
+        depth = blocks[blockOrder[place.block]]->rows[place.index].depth + 1;
+        position = parentPosition + 1 + descendants[parent];
+    }
+
+    const uint32_t index = static_cast<uint32_t>(comments.size());
+    comments.push_back(comment);
+    indexOf.emplace(comment.getId(), index);
+    parents.push_back(parent);
+    descendants.push_back(0);
+    blockOf.push_back(0);
+
+    insertAt(position, Row{ index, depth });
+
+    for (uint32_t ancestor = parent; ancestor != NO_PARENT; ancestor = parents[ancestor])
+        ++descendants[ancestor];
+
+    return true;
+}
+
+// ==================== Lookup ====================
+
+const Comment* CommentThread::find(int commentId) const
+{
+    auto it = indexOf.find(commentId);
+    return it == indexOf.end() ? nullptr : &comments[it->second];
+}
+
+size_t CommentThread::replyCount(int commentId) const
+{
+    auto it = indexOf.find(commentId);
+    return it == indexOf.end() ? 0 : descendants[it->second];
+}
+
+std::vector<CommentRow> CommentThread::page(size_t offset, size_t count) const
+{
+    if (offset >= comments.size())
+        return {};
+
+    return rows(offset, std::min(count, comments.size() - offset));
+}
+
+std::vector<CommentRow> CommentThread::subtree(int commentId, size_t offset, size_t count) const
+{
+    auto it = indexOf.find(commentId);
+    if (it == indexOf.end())
+        return {};
+
+    const size_t length = 1 + descendants[it->second];
+    if (offset >= length)
+        return {};
+
+    return rows(positionOf(it->second) + offset, std::min(count, length - offset));
+}
+
+// ==================== Helpers ====================
+
+// The block is known; only the row within it is searched for
+size_t CommentThread::positionOf(uint32_t comment) const
+{
+    const Block& block = *blocks[blockOf[comment]];
+    size_t index = 0;
+    while (block.rows[index].comment != comment)
+        ++index;
+
+    return rowsBefore[block.order] + index;
+}
+
+// The block holding position, or the end of the last block for size()
+CommentThread::Place CommentThread::placeAt(size_t position) const
+{
+    const size_t order = static_cast<size_t>(
+        std::upper_bound(rowsBefore.begin(), rowsBefore.end(), position) - rowsBefore.begin()) - 1;
+    return Place{ order, position - rowsBefore[order] };
+}
+
+void CommentThread::insertAt(size_t position, Row row)
+{
+    if (blocks.empty()) {
+        blocks.push_back(std::make_unique<Block>());
+        blocks.back()->order = 0;
+        blockOrder.push_back(0);
+        rowsBefore.push_back(0);
+    }
+
+    Place place = placeAt(position);
+
+    // At the very end of a full block, start the next one rather than
+    // splitting: appending top-level comments keeps blocks full
+    Block* block = blocks[blockOrder[place.block]].get();
+    if (place.index == block->rows.size() && block->rows.size() >= BLOCK_SIZE) {
+        const uint32_t id = static_cast<uint32_t>(blocks.size());
+        blocks.push_back(std::make_unique<Block>());
+        blockOrder.insert(blockOrder.begin() + place.block + 1, id);
+        rowsBefore.insert(rowsBefore.begin() + place.block + 1, position);
+        for (size_t order = place.block + 1; order < blockOrder.size(); ++order)
+            blocks[blockOrder[order]]->order = order;
+
+        place = Place{ place.block + 1, 0 };
+        block = blocks[id].get();
+    }
+
+    block->rows.insert(block->rows.begin() + place.index, row);
+    blockOf[row.comment] = blockOrder[place.block];
+    for (size_t order = place.block + 1; order < rowsBefore.size(); ++order)
+        ++rowsBefore[order];
+
+    if (block->rows.size() > BLOCK_SIZE)
+        split(place.block);
+}
+
+// Moves the back half of a block into a new block right after it
+void CommentThread::split(size_t order)
+{
+    Block& full = *blocks[blockOrder[order]];
+    const size_t keep = full.rows.size() / 2;
+
+    const uint32_t id = static_cast<uint32_t>(blocks.size());
+    auto half = std::make_unique<Block>();
+    half->rows.assign(full.rows.begin() + keep, full.rows.end());
+    full.rows.resize(keep);
+
+    for (const Row& row : half->rows)
+        blockOf[row.comment] = id;
+
+    blocks.push_back(std::move(half));
+    blockOrder.insert(blockOrder.begin() + order + 1, id);
+    rowsBefore.insert(rowsBefore.begin() + order + 1, rowsBefore[order] + keep);
+    for (size_t next = order + 1; next < blockOrder.size(); ++next)
+        blocks[blockOrder[next]]->order = next;
+}
+
+std::vector<CommentRow> CommentThread::rows(size_t position, size_t count) const
+{
+    std::vector<CommentRow> result;
+    result.reserve(count);
+
+    Place place = placeAt(position);
+    while (result.size() < count) {
+        const Block& block = *blocks[blockOrder[place.block]];
+        for (size_t i = place.index; i < block.rows.size() && result.size() < count; ++i) {
+            const Row& row = block.rows[i];
+            result.push_back(CommentRow{ &comments[row.comment], row.depth, descendants[row.comment] });
+        }
+        place = Place{ place.block + 1, 0 };
+    }
+
+    return result;
+}
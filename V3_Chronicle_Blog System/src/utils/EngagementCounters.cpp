@@ -0,0 +1,353 @@
+#include "../../include/utils/EngagementCounters.h"
+#include "../../../V2_Guardian_OOP Refactor/include/AtomicFile.h"
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+namespace {
+
+    template <typename Number>
+    bool parseField(std::string_view& line, Number& value)
+    {
+        const size_t comma = line.find(',');
+        const std::string_view field = line.substr(0, comma);
+        line = comma == std::string_view::npos ? std::string_view() : line.substr(comma + 1);
+
+        auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+        return result.ec == std::errc() && result.ptr == field.data() + field.size();
+    }
+
+    void appendHex(std::string& text, const std::string& bytes)
+    {
+        static const char DIGITS[] = "0123456789abcdef";
+        for (unsigned char byte : bytes) {
+            text += DIGITS[byte >> 4];
+            text += DIGITS[byte & 15];
+        }
+    }
+
+    bool parseHex(std::string_view field, std::string& bytes)
+    {
+        if (field.size() % 2 != 0)
+            return false;
+
+        bytes.resize(field.size() / 2);
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            const char* digits = field.data() + 2 * i;
+            unsigned byte = 0;
+            auto result = std::from_chars(digits, digits + 2, byte, 16);
+            if (result.ec != std::errc() || result.ptr != digits + 2)
+                return false;
+            bytes[i] = static_cast<char>(byte);
+        }
+        return true;
+    }
+
+}
+
+// ==================== Constructor / Destructor ====================
+
+EngagementCounters::EngagementCounters(Flush flush, EngagementOptions options)
+    : persist(std::move(flush)), options(options),
+      viewStripes(new ViewStripe[VIEW_STRIPES]), likeStripes(new LikeStripe[LIKE_STRIPES])
+{
+    if (options.flushInterval.count() > 0)
+        flusher = std::thread(&EngagementCounters::flusherLoop, this);
+}
+
+EngagementCounters::~EngagementCounters()
+{
+    if (flusher.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(stopMutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        flusher.join();
+    }
+
+    flush();
+}
+
+// ==================== Views ====================
+
+void EngagementCounters::recordView(int postId)
+{
+    ViewStripe& stripe = viewStripe();
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    ++stripe.pending[postId];
+}
+
+uint64_t EngagementCounters::views(int postId) const
+{
+    std::shared_lock<std::shared_mutex> lock(totalsMutex);
+    auto it = totals.find(postId);
+    return it == totals.end() ? 0 : it->second;
+}
+
+// ==================== Likes ====================
+
+bool EngagementCounters::like(int postId, uint32_t userId)
+{
+    return apply(LikeChange{ postId, userId, true }, true);
+}
+
+bool EngagementCounters::unlike(int postId, uint32_t userId)
+{
+    return apply(LikeChange{ postId, userId, false }, true);
+}
+
+bool EngagementCounters::hasLiked(int postId, uint32_t userId) const
+{
+    const LikeStripe& stripe = likeStripe(postId);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+
+    auto it = stripe.likers.find(postId);
+    return it != stripe.likers.end() && it->second.contains(userId);
+}
+
+size_t EngagementCounters::likeCount(int postId) const
+{
+    const LikeStripe& stripe = likeStripe(postId);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+
+    auto it = stripe.likers.find(postId);
+    return it == stripe.likers.end() ? 0 : it->second.size();
+}
+
+// ==================== Storage ====================
+
+bool EngagementCounters::flush()
+{
+    std::lock_guard<std::mutex> flushLock(flushMutex);
+    return flushLocked();
+}
+
+// Rewrites the journal as one line per post's views and one per post's
+// likers, "likers,<post>,<hex>" holding its bitmap's serialize(). Likes
+// made while it runs may be appended again later, which replays the same.
+bool EngagementCounters::compact(const std::string& path)
+{
+    std::lock_guard<std::mutex> flushLock(flushMutex);
+    if (!flushLocked())
+        return false;
+
+    std::string text;
+    {
+        std::shared_lock<std::shared_mutex> lock(totalsMutex);
+        for (const auto& [postId, count] : totals)
+            text += "view," + std::to_string(postId) + ',' + std::to_string(count) + '\n';
+    }
+
+    for (size_t i = 0; i < LIKE_STRIPES; ++i) {
+        std::lock_guard<std::mutex> lock(likeStripes[i].mutex);
+        for (const auto& [postId, likers] : likeStripes[i].likers) {
+            text += "likers," + std::to_string(postId) + ',';
+            appendHex(text, likers.serialize());
+            text += '\n';
+        }
+    }
+
+    return AtomicFile::replace(path, { text });
+}
+
+// One change per line: "view,<post>,<count>", "like,<post>,<user>" or
+// "unlike,<post>,<user>". A batch that fails to append or sync is cut back
+// off the file, since flush() appends it again and a second copy of its
+// views would be counted twice.
+EngagementCounters::Flush EngagementCounters::journal(const std::string& path)
+{
+    return [path](const Batch& batch) {
+        std::error_code error;
+        uintmax_t before = std::filesystem::file_size(path, error);
+        if (error) {
+            if (error != std::errc::no_such_file_or_directory)
+                return false;
+            before = 0;
+        }
+
+        std::string text;
+        for (const ViewDelta& delta : batch.views)
+            text += "view," + std::to_string(delta.postId) + ',' + std::to_string(delta.views) + '\n';
+        for (const LikeChange& change : batch.likes)
+            text += (change.liked ? "like," : "unlike,") + std::to_string(change.postId) + ','
+                + std::to_string(change.userId) + '\n';
+
+        bool written;
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::app);
+            file.write(text.data(), static_cast<std::streamsize>(text.size()));
+            file.close();
+            written = static_cast<bool>(file);
+        }
+
+        if (written && AtomicFile::sync(path))
+            return true;
+
+        // Lines that could not be cut off are in the file and must not be
+        // appended again, unless the write itself failed part way
+        std::filesystem::resize_file(path, before, error);
+        return written && error;
+    };
+}
+
+// Only lines ending in '\n' count: a crash mid-append can leave a tail
+// that still parses, "view,5,12" of "view,5,1234". That tail is dropped
+// and cut off the file, so the next append starts on a line of its own.
+bool EngagementCounters::restore(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    uint64_t complete = 0; // bytes up to the last newline
+    bool torn = false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (file.eof()) {
+            torn = true;
+            break;
+        }
+        complete += line.size() + 1;
+
+        std::string_view rest = line;
+        const size_t comma = rest.find(',');
+        const std::string_view kind = rest.substr(0, comma);
+        if (comma == std::string_view::npos)
+            continue;
+        rest.remove_prefix(comma + 1);
+
+        int postId = 0;
+        if (!parseField(rest, postId))
+            continue;
+
+        if (kind == "likers") {
+            std::string bytes;
+            RoaringBitmap likers;
+            if (parseHex(rest, bytes) && likers.deserialize(bytes))
+                likers.forEach([&](uint32_t userId) { apply(LikeChange{ postId, userId, true }, false); });
+            continue;
+        }
+
+        uint64_t value = 0;
+        if (!parseField(rest, value))
+            continue;
+
+        if (kind == "view") {
+            std::unique_lock<std::shared_mutex> lock(totalsMutex);
+            totals[postId] += value;
+        }
+        else if ((kind == "like" || kind == "unlike") && value <= UINT32_MAX) {
+            apply(LikeChange{ postId, static_cast<uint32_t>(value), kind == "like" }, false);
+        }
+    }
+
+    file.close();
+    if (torn) {
+        std::error_code error;
+        std::filesystem::resize_file(path, complete, error);
+        return !error;
+    }
+
+    return true;
+}
+
+// ==================== Helpers ====================
+
+bool EngagementCounters::flushLocked()
+{
+    // Swap each stripe's deltas out under its lock, merge them outside it
+    std::unordered_map<int, uint64_t> drained;
+    for (size_t i = 0; i < VIEW_STRIPES; ++i) {
+        std::unordered_map<int, uint64_t> pending;
+        {
+            std::lock_guard<std::mutex> lock(viewStripes[i].mutex);
+            pending.swap(viewStripes[i].pending);
+        }
+        for (const auto& [postId, count] : pending)
+            drained[postId] += count;
+    }
+
+    for (size_t i = 0; i < LIKE_STRIPES; ++i) {
+        std::lock_guard<std::mutex> lock(likeStripes[i].mutex);
+        unflushedLikes.insert(unflushedLikes.end(), likeStripes[i].changes.begin(), likeStripes[i].changes.end());
+        likeStripes[i].changes.clear();
+    }
+
+    if (!drained.empty()) {
+        std::unique_lock<std::shared_mutex> lock(totalsMutex);
+        for (const auto& [postId, count] : drained)
+            totals[postId] += count;
+    }
+
+    if (!persist) {
+        unflushedLikes.clear();
+        return true;
+    }
+
+    for (const auto& [postId, count] : drained)
+        unflushedViews[postId] += count;
+
+    Batch batch;
+    batch.views.reserve(unflushedViews.size());
+    for (const auto& [postId, count] : unflushedViews)
+        batch.views.push_back(ViewDelta{ postId, count });
+    batch.likes.swap(unflushedLikes);
+
+    if (batch.empty())
+        return true;
+
+    if (!persist(batch)) {
+        batch.likes.swap(unflushedLikes); // retried, in order, with the next batch
+        return false;
+    }
+
+    unflushedViews.clear();
+    return true;
+}
+
+EngagementCounters::ViewStripe& EngagementCounters::viewStripe()
+{
+    static thread_local const size_t stripe =
+        std::hash<std::thread::id>()(std::this_thread::get_id()) % VIEW_STRIPES;
+    return viewStripes[stripe];
+}
+
+EngagementCounters::LikeStripe& EngagementCounters::likeStripe(int postId) const
+{
+    return likeStripes[static_cast<unsigned>(postId) % LIKE_STRIPES];
+}
+
+bool EngagementCounters::apply(const LikeChange& change, bool logged)
+{
+    LikeStripe& stripe = likeStripe(change.postId);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+
+    bool changed;
+    if (change.liked) {
+        changed = stripe.likers[change.postId].add(change.userId);
+    }
+    else {
+        auto it = stripe.likers.find(change.postId);
+        changed = it != stripe.likers.end() && it->second.remove(change.userId);
+        if (changed && it->second.empty())
+            stripe.likers.erase(it);
+    }
+
+    if (changed && logged && persist)
+        stripe.changes.push_back(change);
+    return changed;
+}
+
+void EngagementCounters::flusherLoop()
+{
+    std::unique_lock<std::mutex> lock(stopMutex);
+
+    while (!wake.wait_for(lock, options.flushInterval, [this] { return stopping; })) {
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
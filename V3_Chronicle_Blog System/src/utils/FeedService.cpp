@@ -0,0 +1,219 @@
+#include "../../include/utils/FeedService.h"
+#include <algorithm>
+#include <mutex>
+
+FeedService::FeedService(FeedOptions options)
+    : options(options)
+{
+    this->options.inboxCapacity = std::max<size_t>(1, options.inboxCapacity);
+    this->options.authorHistory = std::max<size_t>(1, options.authorHistory);
+}
+
+// ==================== Follows ====================
+
+bool FeedService::follow(int followerId, int authorId)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    Reader& reader = readers[followerId];
+    if (!reader.following.insert(authorId).second)
+        return false;
+
+    Author& author = authors[authorId];
+    author.followers.insert(followerId);
+
+    if (author.pulled)
+        reader.pulledFollowing.push_back(authorId);
+    else if (author.followers.size() > options.pullThreshold)
+        startPulling(author, authorId);
+    else
+        backfill(reader, author);
+
+    return true;
+}
+
+bool FeedService::unfollow(int followerId, int authorId)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    auto reader = readers.find(followerId);
+    if (reader == readers.end() || reader->second.following.erase(authorId) == 0)
+        return false;
+
+    Author& author = authors[authorId];
+    author.followers.erase(followerId);
+
+    if (author.pulled) {
+        std::vector<int>& pulled = reader->second.pulledFollowing;
+        pulled.erase(std::find(pulled.begin(), pulled.end(), authorId));
+    }
+    purge(reader->second, authorId);
+
+    return true;
+}
+
+size_t FeedService::followerCount(int authorId) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = authors.find(authorId);
+    return it == authors.end() ? 0 : it->second.followers.size();
+}
+
+bool FeedService::isPulled(int authorId) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = authors.find(authorId);
+    return it != authors.end() && it->second.pulled;
+}
+
+// ==================== Publishing ====================
+
+uint64_t FeedService::publish(int authorId, int postId)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    const FeedItem item{ postId, authorId, ++lastSequence };
+
+    Author& author = authors[authorId];
+    author.history.push(item, options.authorHistory);
+
+    if (!author.pulled) {
+        for (int followerId : author.followers)
+            readers[followerId].inbox.push(item, options.inboxCapacity);
+    }
+
+    return item.sequence;
+}
+
+// ==================== Reading ====================
+
+FeedPage FeedService::feed(int userId, size_t pageSize, uint64_t cursor) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+
+    FeedPage page;
+    auto found = readers.find(userId);
+    if (found == readers.end() || pageSize == 0)
+        return page;
+
+    const Reader& reader = found->second;
+
+    struct Source {
+        const Ring* ring;
+        size_t index;
+        bool inbox;
+    };
+
+    std::vector<Source> sources;
+    sources.reserve(reader.pulledFollowing.size() + 1);
+    sources.push_back(Source{ &reader.inbox, reader.inbox.firstBefore(cursor), true });
+    for (int authorId : reader.pulledFollowing) {
+        const Ring& history = authors.at(authorId).history;
+        sources.push_back(Source{ &history, history.firstBefore(cursor), false });
+    }
+
+    // Max-heap on each source's next sequence: a k-way merge
+    auto older = [](const Source& a, const Source& b) {
+        return a.ring->newest(a.index).sequence < b.ring->newest(b.index).sequence;
+    };
+    sources.erase(std::remove_if(sources.begin(), sources.end(),
+        [](const Source& source) { return source.index >= source.ring->size(); }), sources.end());
+    std::make_heap(sources.begin(), sources.end(), older);
+
+    while (!sources.empty() && page.items.size() < pageSize) {
+        std::pop_heap(sources.begin(), sources.end(), older);
+        Source& source = sources.back();
+        const FeedItem& item = source.ring->newest(source.index);
+
+        // Pushed before the author went over to pulling; their history has it
+        if (!source.inbox || !authors.at(item.authorId).pulled)
+            page.items.push_back(item);
+
+        if (++source.index < source.ring->size())
+            std::push_heap(sources.begin(), sources.end(), older);
+        else
+            sources.pop_back();
+    }
+
+    if (page.items.size() == pageSize && !sources.empty())
+        page.nextCursor = page.items.back().sequence;
+    return page;
+}
+
+// ==================== Helpers ====================
+
+void FeedService::Ring::push(const FeedItem& item, size_t capacity)
+{
+    if (items.size() < capacity) {
+        items.push_back(item);
+        return;
+    }
+
+    items[next] = item;
+    next = (next + 1) % items.size();
+}
+
+void FeedService::Ring::assign(const std::vector<FeedItem>& newestFirst)
+{
+    items.assign(newestFirst.rbegin(), newestFirst.rend());
+    next = 0;
+}
+
+// Sequences fall with the newest-first index: binary search
+size_t FeedService::Ring::firstBefore(uint64_t cursor) const
+{
+    if (cursor == 0)
+        return 0;
+
+    size_t low = 0;
+    size_t high = items.size();
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        if (newest(middle).sequence < cursor)
+            high = middle;
+        else
+            low = middle + 1;
+    }
+    return low;
+}
+
+// Merges the author's recent posts into a new follower's inbox, which
+// holds none of them: unfollowing purged any earlier ones
+void FeedService::backfill(Reader& reader, const Author& author)
+{
+    if (author.history.size() == 0)
+        return;
+
+    std::vector<FeedItem> merged;
+    merged.reserve(reader.inbox.size() + author.history.size());
+
+    size_t i = 0;
+    size_t j = 0;
+    while (merged.size() < options.inboxCapacity && (i < reader.inbox.size() || j < author.history.size())) {
+        const bool fromInbox = j == author.history.size()
+            || (i < reader.inbox.size() && reader.inbox.newest(i).sequence > author.history.newest(j).sequence);
+        merged.push_back(fromInbox ? reader.inbox.newest(i++) : author.history.newest(j++));
+    }
+
+    reader.inbox.assign(merged);
+}
+
+void FeedService::purge(Reader& reader, int authorId)
+{
+    std::vector<FeedItem> kept;
+    kept.reserve(reader.inbox.size());
+    for (size_t i = 0; i < reader.inbox.size(); ++i) {
+        if (reader.inbox.newest(i).authorId != authorId)
+            kept.push_back(reader.inbox.newest(i));
+    }
+
+    if (kept.size() != reader.inbox.size())
+        reader.inbox.assign(kept);
+}
+
+void FeedService::startPulling(Author& author, int authorId)
+{
+    author.pulled = true;
+    for (int followerId : author.followers)
+        readers[followerId].pulledFollowing.push_back(authorId);
+}
@@ -0,0 +1,266 @@
+#include "../../include/utils/RoaringBitmap.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+    const char BITMAP_MAGIC[4] = { 'R', 'B', 'M', '1' };
+
+    void putUint32(std::string& out, uint32_t value)
+    {
+        for (int shift = 0; shift < 32; shift += 8)
+            out.push_back(static_cast<char>((value >> shift) & 0xff));
+    }
+
+    bool getUint32(std::string_view data, size_t& offset, uint32_t& value)
+    {
+        if (data.size() - offset < 4)
+            return false;
+
+        value = 0;
+        for (int i = 0; i < 4; ++i)
+            value |= static_cast<uint32_t>(static_cast<unsigned char>(data[offset++])) << (8 * i);
+        return true;
+    }
+
+}
+
+// ==================== Membership ====================
+
+bool RoaringBitmap::add(uint32_t id)
+{
+    const uint16_t key = static_cast<uint16_t>(id >> 16);
+    const uint16_t low = static_cast<uint16_t>(id);
+
+    auto it = std::lower_bound(containers.begin(), containers.end(), key,
+        [](const Container& container, uint16_t value) { return container.key < value; });
+    if (it == containers.end() || it->key != key) {
+        it = containers.insert(it, Container());
+        it->key = key;
+    }
+
+    Container& container = *it;
+    if (container.isBitmap()) {
+        uint64_t& word = container.bits[low >> 6];
+        const uint64_t bit = 1ull << (low & 63);
+        if (word & bit)
+            return false;
+        word |= bit;
+    }
+    else {
+        auto position = std::lower_bound(container.array.begin(), container.array.end(), low);
+        if (position != container.array.end() && *position == low)
+            return false;
+        container.array.insert(position, low);
+    }
+
+    ++container.count;
+    ++cardinality;
+
+    if (!container.isBitmap() && container.count > ARRAY_LIMIT)
+        toBitmap(container);
+    return true;
+}
+
+bool RoaringBitmap::remove(uint32_t id)
+{
+    const uint16_t key = static_cast<uint16_t>(id >> 16);
+    const uint16_t low = static_cast<uint16_t>(id);
+
+    auto it = std::lower_bound(containers.begin(), containers.end(), key,
+        [](const Container& container, uint16_t value) { return container.key < value; });
+    if (it == containers.end() || it->key != key)
+        return false;
+
+    Container& container = *it;
+    if (container.isBitmap()) {
+        uint64_t& word = container.bits[low >> 6];
+        const uint64_t bit = 1ull << (low & 63);
+        if (!(word & bit))
+            return false;
+        word &= ~bit;
+    }
+    else {
+        auto position = std::lower_bound(container.array.begin(), container.array.end(), low);
+        if (position == container.array.end() || *position != low)
+            return false;
+        container.array.erase(position);
+    }
+
+    --container.count;
+    --cardinality;
+
+    if (container.count == 0)
+        containers.erase(it);
+    else if (container.isBitmap() && container.count <= ARRAY_LIMIT / 2)
+        toArray(container); // half the limit, so one id cannot flip it back and forth
+    return true;
+}
+
+bool RoaringBitmap::contains(uint32_t id) const
+{
+    const Container* container = find(static_cast<uint16_t>(id >> 16));
+    if (container == nullptr)
+        return false;
+
+    const uint16_t low = static_cast<uint16_t>(id);
+    if (container->isBitmap())
+        return (container->bits[low >> 6] >> (low & 63)) & 1;
+
+    return std::binary_search(container->array.begin(), container->array.end(), low);
+}
+
+// ==================== Serialization ====================
+
+// Magic, container count, then per container its key and count followed
+// by the ids' low halves (up to ARRAY_LIMIT) or BITMAP_WORDS words, all
+// little-endian
+std::string RoaringBitmap::serialize() const
+{
+    std::string out(BITMAP_MAGIC, sizeof(BITMAP_MAGIC));
+    putUint32(out, static_cast<uint32_t>(containers.size()));
+
+    for (const Container& container : containers) {
+        putUint32(out, container.key);
+        putUint32(out, container.count);
+
+        if (container.count > ARRAY_LIMIT) {
+            for (uint64_t word : container.bits) {
+                putUint32(out, static_cast<uint32_t>(word));
+                putUint32(out, static_cast<uint32_t>(word >> 32));
+            }
+            continue;
+        }
+
+        // A bitmap that has shrunk below the limit is still written as an
+        // array, so the count alone tells a reader the layout
+        auto putLow = [&out](uint32_t id) {
+            out.push_back(static_cast<char>(id & 0xff));
+            out.push_back(static_cast<char>((id >> 8) & 0xff));
+        };
+        if (container.isBitmap()) {
+            for (size_t word = 0; word < BITMAP_WORDS; ++word) {
+                for (uint64_t bits = container.bits[word]; bits != 0; bits &= bits - 1)
+                    putLow(static_cast<uint32_t>(word * 64 + lowestSetBit(bits)));
+            }
+        }
+        else {
+            for (uint16_t low : container.array)
+                putLow(low);
+        }
+    }
+
+    return out;
+}
+
+bool RoaringBitmap::deserialize(std::string_view data)
+{
+    containers.clear();
+    cardinality = 0;
+
+    size_t offset = sizeof(BITMAP_MAGIC);
+    uint32_t containerCount = 0;
+    if (data.size() < offset || std::memcmp(data.data(), BITMAP_MAGIC, offset) != 0
+        || !getUint32(data, offset, containerCount))
+        return false;
+
+    std::vector<Container> loaded;
+    size_t total = 0;
+
+    for (uint32_t i = 0; i < containerCount; ++i) {
+        uint32_t key = 0;
+        uint32_t count = 0;
+        if (!getUint32(data, offset, key) || !getUint32(data, offset, count)
+            || key > UINT16_MAX || count == 0 || count > 65536
+            || (!loaded.empty() && loaded.back().key >= key))
+            return false;
+
+        Container container;
+        container.key = static_cast<uint16_t>(key);
+        container.count = count;
+
+        if (count > ARRAY_LIMIT) {
+            container.bits.resize(BITMAP_WORDS);
+            size_t present = 0;
+            for (uint64_t& word : container.bits) {
+                uint32_t low = 0;
+                uint32_t high = 0;
+                if (!getUint32(data, offset, low) || !getUint32(data, offset, high))
+                    return false;
+                word = static_cast<uint64_t>(high) << 32 | low;
+                for (uint64_t bits = word; bits != 0; bits &= bits - 1)
+                    ++present;
+            }
+            if (present != count)
+                return false;
+        }
+        else {
+            if ((data.size() - offset) / 2 < count)
+                return false;
+            container.array.resize(count);
+            for (uint16_t& low : container.array) {
+                low = static_cast<uint16_t>(static_cast<unsigned char>(data[offset])
+                    | static_cast<unsigned char>(data[offset + 1]) << 8);
+                offset += 2;
+            }
+            if (std::adjacent_find(container.array.begin(), container.array.end(),
+                    [](uint16_t a, uint16_t b) { return a >= b; }) != container.array.end())
+                return false;
+        }
+
+        total += count;
+        loaded.push_back(std::move(container));
+    }
+
+    if (offset != data.size())
+        return false;
+
+    containers.swap(loaded);
+    cardinality = total;
+    return true;
+}
+
+// ==================== Helpers ====================
+
+const RoaringBitmap::Container* RoaringBitmap::find(uint16_t key) const
+{
+    auto it = std::lower_bound(containers.begin(), containers.end(), key,
+        [](const Container& container, uint16_t value) { return container.key < value; });
+    return (it != containers.end() && it->key == key) ? &*it : nullptr;
+}
+
+unsigned RoaringBitmap::lowestSetBit(uint64_t bits)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return index;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#endif
+}
+
+void RoaringBitmap::toBitmap(Container& container)
+{
+    container.bits.assign(BITMAP_WORDS, 0);
+    for (uint16_t low : container.array)
+        container.bits[low >> 6] |= 1ull << (low & 63);
+
+    std::vector<uint16_t>().swap(container.array);
+}
+
+void RoaringBitmap::toArray(Container& container)
+{
+    container.array.clear();
+    container.array.reserve(container.count);
+    for (size_t word = 0; word < BITMAP_WORDS; ++word) {
+        for (uint64_t bits = container.bits[word]; bits != 0; bits &= bits - 1)
+            container.array.push_back(static_cast<uint16_t>(word * 64 + lowestSetBit(bits)));
+    }
+
+    std::vector<uint64_t>().swap(container.bits);
+}
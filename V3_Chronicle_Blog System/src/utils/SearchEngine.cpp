@@ -0,0 +1,484 @@
+#include "../../include/utils/SearchEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace {
+
+    // BM25 parameters, the usual defaults
+    const double K1 = 1.2;
+    const double B = 0.75;
+
+    // Sorted for binary search
+    const std::string_view STOP_WORDS[] = {
+        "a", "about", "after", "all", "also", "am", "an", "and", "any", "are", "as", "at",
+        "be", "because", "been", "before", "being", "but", "by", "can", "could", "did", "do",
+        "does", "for", "from", "had", "has", "have", "he", "her", "here", "him", "his", "how",
+        "i", "if", "in", "into", "is", "it", "its", "just", "me", "more", "most", "my", "no",
+        "not", "of", "on", "only", "or", "other", "our", "out", "over", "she", "so", "some",
+        "than", "that", "the", "their", "them", "then", "there", "these", "they", "this",
+        "those", "to", "too", "up", "us", "very", "was", "we", "were", "what", "when", "where",
+        "which", "while", "who", "why", "will", "with", "would", "you", "your"
+    };
+
+    // Letters and digits lower-cased, other ASCII as 0 (a separator).
+    // Bytes of multi-byte UTF-8 characters are kept as they are.
+    struct TermCharacters {
+        char map[256];
+
+        TermCharacters() {
+            for (int c = 0; c < 256; ++c) {
+                if (c >= 'A' && c <= 'Z')
+                    map[c] = static_cast<char>(c - 'A' + 'a');
+                else if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c >= 0x80)
+                    map[c] = static_cast<char>(c);
+                else
+                    map[c] = 0;
+            }
+        }
+    };
+
+    const TermCharacters TERM_CHARACTERS;
+
+    void putVarint(std::vector<uint8_t>& out, uint64_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    uint64_t getVarint(const uint8_t* data, size_t& offset)
+    {
+        uint64_t value = 0;
+        for (int shift = 0;; shift += 7) {
+            uint8_t byte = data[offset++];
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (byte < 0x80)
+                return value;
+        }
+    }
+
+}
+
+// ==================== Cursor ====================
+
+// Walks one posting list in document order
+class SearchEngine::Cursor {
+public:
+    explicit Cursor(const PostingList& list)
+        : list(&list)
+    {
+        if (list.count > 0)
+            decode();
+    }
+
+    bool valid() const { return index < list->count; }
+    uint32_t count() const { return list->count; }
+
+    void next()
+    {
+        if (++index < list->count)
+            decode();
+    }
+
+    // Moves to the first posting at or after target, skipping whole
+    // blocks that end before it
+    void advance(uint32_t target)
+    {
+        if (!valid() || document >= target)
+            return;
+
+        size_t block = index / BLOCK_SIZE;
+        if (list->skips[block].lastDocument < target) {
+            auto skip = std::lower_bound(list->skips.begin() + block + 1, list->skips.end(), target,
+                [](const Skip& entry, uint32_t value) { return entry.lastDocument < value; });
+
+            if (skip == list->skips.end()) {
+                index = list->count;
+                return;
+            }
+
+            index = static_cast<uint32_t>(skip - list->skips.begin()) * BLOCK_SIZE;
+            offset = skip->offset;
+            document = skip->baseDocument;
+            decode();
+        }
+
+        while (valid() && document < target)
+            next();
+    }
+
+    uint32_t document = 0;
+    uint32_t titleFrequency = 0;
+    uint32_t contentFrequency = 0;
+
+private:
+    // Posting layout: varint(delta << 1 | in title), varint(content
+    // frequency), then varint(title frequency) only when in title
+    void decode()
+    {
+        const uint8_t* data = list->bytes.data();
+        uint64_t head = getVarint(data, offset);
+        document += static_cast<uint32_t>(head >> 1);
+        contentFrequency = static_cast<uint32_t>(getVarint(data, offset));
+        titleFrequency = (head & 1) ? static_cast<uint32_t>(getVarint(data, offset)) : 0;
+    }
+
+    const PostingList* list;
+    uint32_t index = 0;
+    size_t offset = 0;
+};
+
+// ==================== Indexing ====================
+
+void SearchEngine::indexPost(const Post& post)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    auto it = documentOf.find(post.getId());
+    if (it != documentOf.end())
+        removeDocument(it->second);
+
+    addDocument(post);
+}
+
+bool SearchEngine::removePost(int postId)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    auto it = documentOf.find(postId);
+    if (it == documentOf.end())
+        return false;
+
+    removeDocument(it->second);
+    return true;
+}
+
+// Renumbers the live documents densely and rewrites every posting list
+// without the dead ones; terms left with no postings are forgotten
+void SearchEngine::rebuildIndex()
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    const uint32_t DEAD = UINT32_MAX;
+    std::vector<uint32_t> renumbered(documents.size(), DEAD);
+    std::vector<Document> live;
+    live.reserve(documentOf.size());
+
+    for (size_t i = 0; i < documents.size(); ++i) {
+        if (documents[i].removed)
+            continue;
+
+        renumbered[i] = static_cast<uint32_t>(live.size());
+        documentOf[documents[i].postId] = renumbered[i];
+        live.push_back(documents[i]);
+    }
+
+    std::vector<PostingList> compacted;
+    for (auto it = termIds.begin(); it != termIds.end();) {
+        PostingList list;
+        for (Cursor cursor(postings[it->second]); cursor.valid(); cursor.next()) {
+            uint32_t document = renumbered[cursor.document];
+            if (document != DEAD)
+                append(list, document, cursor.titleFrequency, cursor.contentFrequency);
+        }
+
+        if (list.count == 0) {
+            it = termIds.erase(it);
+            continue;
+        }
+
+        list.bytes.shrink_to_fit();
+        list.skips.shrink_to_fit();
+        it->second = static_cast<uint32_t>(compacted.size());
+        compacted.push_back(std::move(list));
+        ++it;
+    }
+
+    postings.swap(compacted);
+    documents.swap(live);
+}
+
+void SearchEngine::addDocument(const Post& post)
+{
+    // Every term with the field it came from; sorting groups the
+    // occurrences of a term so each list gets one posting
+    std::vector<std::pair<std::string_view, bool>> occurrences;
+    std::string titleBuffer;
+    std::string contentBuffer;
+
+    forEachTerm(post.getTitle(), titleBuffer, [&](std::string_view term) {
+        occurrences.emplace_back(term, true);
+    });
+    const uint32_t titleLength = static_cast<uint32_t>(occurrences.size());
+
+    forEachTerm(post.getContent(), contentBuffer, [&](std::string_view term) {
+        occurrences.emplace_back(term, false);
+    });
+    const uint32_t contentLength = static_cast<uint32_t>(occurrences.size()) - titleLength;
+
+    std::sort(occurrences.begin(), occurrences.end());
+
+    const uint32_t document = static_cast<uint32_t>(documents.size());
+
+    for (size_t i = 0; i < occurrences.size();) {
+        const std::string_view term = occurrences[i].first;
+        uint32_t titleFrequency = 0;
+        uint32_t contentFrequency = 0;
+
+        for (; i < occurrences.size() && occurrences[i].first == term; ++i) {
+            if (occurrences[i].second)
+                ++titleFrequency;
+            else
+                ++contentFrequency;
+        }
+
+        auto inserted = termIds.try_emplace(std::string(term), static_cast<uint32_t>(postings.size()));
+        if (inserted.second)
+            postings.emplace_back();
+
+        append(postings[inserted.first->second], document, titleFrequency, contentFrequency);
+    }
+
+    documents.push_back(Document{ post.getId(), titleLength, contentLength, false });
+    documentOf[post.getId()] = document;
+    titleLengthTotal += titleLength;
+    contentLengthTotal += contentLength;
+}
+
+// Its postings stay until rebuildIndex(); queries skip them
+void SearchEngine::removeDocument(uint32_t document)
+{
+    Document& entry = documents[document];
+    entry.removed = true;
+    titleLengthTotal -= entry.titleLength;
+    contentLengthTotal -= entry.contentLength;
+    documentOf.erase(entry.postId);
+}
+
+void SearchEngine::append(PostingList& list, uint32_t document, uint32_t titleFrequency,
+    uint32_t contentFrequency)
+{
+    const uint32_t previous = list.skips.empty() ? 0 : list.skips.back().lastDocument;
+
+    if (list.count % BLOCK_SIZE == 0)
+        list.skips.push_back(Skip{ document, previous, static_cast<uint32_t>(list.bytes.size()) });
+    list.skips.back().lastDocument = document;
+
+    putVarint(list.bytes, (static_cast<uint64_t>(document - previous) << 1) | (titleFrequency != 0));
+    putVarint(list.bytes, contentFrequency);
+    if (titleFrequency != 0)
+        putVarint(list.bytes, titleFrequency);
+
+    ++list.count;
+}
+
+// ==================== Ranked retrieval ====================
+
+std::vector<SearchResult> SearchEngine::search(std::string_view query, size_t limit) const
+{
+    return this->query(query, limit, Field::ALL);
+}
+
+std::vector<SearchResult> SearchEngine::searchByTitle(std::string_view query, size_t limit) const
+{
+    return this->query(query, limit, Field::TITLE);
+}
+
+std::vector<SearchResult> SearchEngine::searchByContent(std::string_view query, size_t limit) const
+{
+    return this->query(query, limit, Field::CONTENT);
+}
+
+std::vector<SearchResult> SearchEngine::query(std::string_view text, size_t limit, Field field) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::vector<SearchResult> results;
+
+    std::string buffer;
+    std::vector<std::string_view> words;
+    forEachTerm(text, buffer, [&](std::string_view term) { words.push_back(term); });
+
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+
+    const double liveDocuments = static_cast<double>(documentOf.size());
+    if (limit == 0 || words.empty() || liveDocuments == 0)
+        return results;
+
+    // A term nobody used means no post has them all
+    std::vector<Cursor> cursors;
+    cursors.reserve(words.size());
+    for (std::string_view word : words) {
+        auto it = termIds.find(std::string(word));
+        if (it == termIds.end())
+            return results;
+        cursors.emplace_back(postings[it->second]);
+    }
+
+    // The rarest term leads; the others only ever skip ahead to it
+    std::sort(cursors.begin(), cursors.end(),
+        [](const Cursor& a, const Cursor& b) { return a.count() < b.count(); });
+
+    std::vector<double> idf;
+    for (const Cursor& cursor : cursors) {
+        // Dead postings still count towards df until rebuildIndex()
+        double df = std::min(static_cast<double>(cursor.count()), liveDocuments);
+        idf.push_back(std::log(1.0 + (liveDocuments - df + 0.5) / (df + 0.5)));
+    }
+
+    double averageLength;
+    if (field == Field::TITLE)
+        averageLength = titleLengthTotal / liveDocuments;
+    else if (field == Field::CONTENT)
+        averageLength = contentLengthTotal / liveDocuments;
+    else
+        averageLength = (TITLE_WEIGHT * titleLengthTotal + contentLengthTotal) / liveDocuments;
+    averageLength = std::max(averageLength, 1.0);
+
+    // Min-heap on score holding the best limit so far
+    auto better = [](const SearchResult& a, const SearchResult& b) {
+        return a.score > b.score || (a.score == b.score && a.postId < b.postId);
+    };
+    std::vector<SearchResult> heap;
+
+    Cursor& lead = cursors.front();
+    bool exhausted = false;
+
+    while (lead.valid()) {
+        const uint32_t candidate = lead.document;
+        uint32_t overshoot = candidate;
+
+        for (size_t i = 1; i < cursors.size() && overshoot == candidate; ++i) {
+            cursors[i].advance(candidate);
+            if (!cursors[i].valid())
+                exhausted = true;
+            else
+                overshoot = cursors[i].document;
+        }
+
+        if (exhausted)
+            break;
+
+        if (overshoot != candidate) {
+            lead.advance(overshoot);
+            continue;
+        }
+
+        const Document& document = documents[candidate];
+        double score = 0;
+        bool inField = !document.removed;
+
+        for (size_t i = 0; i < cursors.size() && inField; ++i) {
+            double frequency;
+            double length;
+
+            if (field == Field::TITLE) {
+                frequency = cursors[i].titleFrequency;
+                length = document.titleLength;
+            }
+            else if (field == Field::CONTENT) {
+                frequency = cursors[i].contentFrequency;
+                length = document.contentLength;
+            }
+            else {
+                frequency = TITLE_WEIGHT * cursors[i].titleFrequency + cursors[i].contentFrequency;
+                length = TITLE_WEIGHT * document.titleLength + document.contentLength;
+            }
+
+            inField = frequency > 0;
+            score += idf[i] * frequency * (K1 + 1)
+                / (frequency + K1 * (1 - B + B * length / averageLength));
+        }
+
+        if (inField) {
+            SearchResult result{ document.postId, score };
+
+            if (heap.size() < limit) {
+                heap.push_back(result);
+                std::push_heap(heap.begin(), heap.end(), better);
+            }
+            else if (better(result, heap.front())) {
+                std::pop_heap(heap.begin(), heap.end(), better);
+                heap.back() = result;
+                std::push_heap(heap.begin(), heap.end(), better);
+            }
+        }
+
+        lead.next();
+    }
+
+    std::sort_heap(heap.begin(), heap.end(), better);
+    return heap;
+}
+
+// ==================== Statistics ====================
+
+SearchEngine::Stats SearchEngine::stats() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+
+    Stats stats;
+    stats.posts = documentOf.size();
+    stats.documents = documents.size();
+    stats.terms = termIds.size();
+
+    size_t skipBytes = 0;
+    for (const PostingList& list : postings) {
+        stats.postings += list.count;
+        stats.postingBytes += list.bytes.size();
+        skipBytes += list.skips.size() * sizeof(Skip);
+    }
+
+    // Hash nodes estimated at a next pointer, the entry, the cached hash
+    // and the term's characters
+    size_t vocabularyBytes = termIds.bucket_count() * sizeof(void*);
+    for (const auto& entry : termIds)
+        vocabularyBytes += sizeof(void*) + sizeof(entry) + sizeof(size_t) + entry.first.size();
+
+    stats.indexBytes = stats.postingBytes + skipBytes + vocabularyBytes
+        + postings.size() * sizeof(PostingList)
+        + documents.size() * sizeof(Document)
+        + documentOf.size() * (sizeof(void*) * 2 + sizeof(std::pair<const int, uint32_t>));
+
+    return stats;
+}
+
+// ==================== Tokenizer ====================
+
+std::vector<std::string> SearchEngine::tokenize(std::string_view text)
+{
+    std::vector<std::string> terms;
+    std::string buffer;
+    forEachTerm(text, buffer, [&](std::string_view term) { terms.emplace_back(term); });
+    return terms;
+}
+
+// Lower-cases text into buffer and calls back with a view of each
+// indexable term there; the views live as long as buffer is untouched
+template <typename Callback>
+void SearchEngine::forEachTerm(std::string_view text, std::string& buffer, Callback&& callback)
+{
+    buffer.resize(text.size());
+    for (size_t i = 0; i < text.size(); ++i)
+        buffer[i] = TERM_CHARACTERS.map[static_cast<unsigned char>(text[i])];
+
+    size_t start = 0;
+    for (size_t i = 0; i <= buffer.size(); ++i) {
+        if (i < buffer.size() && buffer[i] != 0)
+            continue;
+
+        const std::string_view term(buffer.data() + start, i - start);
+        if (!term.empty() && term.size() <= MAX_TERM_LENGTH && !isStopWord(term))
+            callback(term);
+
+        start = i + 1;
+    }
+}
+
+bool SearchEngine::isStopWord(std::string_view term)
+{
+    return std::binary_search(std::begin(STOP_WORDS), std::end(STOP_WORDS), term);
+}
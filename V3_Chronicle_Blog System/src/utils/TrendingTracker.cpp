@@ -0,0 +1,250 @@
+#include "../../include/utils/TrendingTracker.h"
+#include "../../../V2_Guardian_OOP Refactor/include/Timestamp.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+    const double NO_POINTS = -std::numeric_limits<double>::infinity();
+
+    // log2(2^a + 2^b) without leaving log space
+    double logAdd(double a, double b)
+    {
+        if (a == NO_POINTS)
+            return b;
+        if (b == NO_POINTS)
+            return a;
+
+        const double high = std::max(a, b);
+        return high + std::log2(1.0 + std::exp2(std::min(a, b) - high));
+    }
+
+    int64_t floorDivide(int64_t value, int64_t divisor)
+    {
+        int64_t quotient = value / divisor;
+        if ((value % divisor != 0) && ((value < 0) != (divisor < 0)))
+            --quotient;
+        return quotient;
+    }
+
+}
+
+TrendingTracker::TrendingTracker(TrendingOptions options)
+    : options(options)
+{
+    if (windowed()) {
+        this->options.bucketSeconds = std::max<int64_t>(1, this->options.bucketSeconds);
+        const int64_t slots = (this->options.windowSeconds + this->options.bucketSeconds - 1)
+            / this->options.bucketSeconds;
+        buckets.resize(static_cast<size_t>(slots));
+    }
+
+    std::atomic_store(&snapshot, std::shared_ptr<const Snapshot>(std::make_shared<Snapshot>()));
+}
+
+// ==================== Posts ====================
+
+void TrendingTracker::addPost(int postId, int64_t createdAt)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (posts.count(postId) > 0)
+        return;
+
+    const double initial = windowed() ? 0.0 : NO_POINTS;
+    posts.emplace(postId, Entry{ initial, createdAt });
+    byScore.insert(Key{ initial, createdAt, postId });
+    byCreation.insert(Key{ static_cast<double>(createdAt), createdAt, postId });
+
+    changed();
+}
+
+bool TrendingTracker::removePost(int postId)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = posts.find(postId);
+    if (it == posts.end())
+        return false;
+
+    const Entry& entry = it->second;
+    byScore.erase(Key{ entry.score, entry.createdAt, postId });
+    byCreation.erase(Key{ static_cast<double>(entry.createdAt), entry.createdAt, postId });
+    posts.erase(it);
+
+    // Its points must not come back out of a later post with the same id
+    for (auto& bucket : buckets)
+        bucket.erase(postId);
+
+    changed();
+    return true;
+}
+
+// ==================== Events ====================
+
+bool TrendingTracker::record(int postId, EngagementType type, int64_t at)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = posts.find(postId);
+    if (it == posts.end())
+        return false;
+
+    const double points = weight(type);
+    latest = std::max(latest, at);
+
+    if (windowed()) {
+        const int64_t bucket = floorDivide(at, options.bucketSeconds);
+        if (bucket > headBucket)
+            expireBuckets(bucket);
+
+        // Already slid out of the window
+        const int64_t slots = static_cast<int64_t>(buckets.size());
+        if (bucket <= headBucket - slots)
+            return false;
+
+        const int64_t slot = ((bucket % slots) + slots) % slots;
+        buckets[static_cast<size_t>(slot)][postId] += points;
+        setScore(postId, it->second, it->second.score + points);
+    }
+    else {
+        // Weighted by 2^(at / halfLife) against a fixed landmark at 0, so
+        // an older event counts for less without touching anyone's score
+        const double scaled = std::log2(points) + static_cast<double>(at) / options.halfLifeSeconds;
+        setScore(postId, it->second, logAdd(it->second.score, scaled));
+    }
+
+    changed();
+    return true;
+}
+
+bool TrendingTracker::record(int postId, EngagementType type)
+{
+    return record(postId, type, Timestamp::now());
+}
+
+void TrendingTracker::advance(int64_t now)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    latest = std::max(latest, now);
+    if (windowed()) {
+        const int64_t bucket = floorDivide(now, options.bucketSeconds);
+        if (bucket > headBucket)
+            expireBuckets(bucket);
+    }
+
+    changed();
+}
+
+double TrendingTracker::weight(EngagementType type)
+{
+    switch (type) {
+    case EngagementType::VIEW: return 1.0;
+    case EngagementType::LIKE: return 10.0;
+    case EngagementType::COMMENT: return 5.0;
+    }
+    return 0.0;
+}
+
+// ==================== Rankings ====================
+
+std::vector<TrendingEntry> TrendingTracker::trending(size_t count) const
+{
+    std::shared_ptr<const Snapshot> published = current();
+    const size_t n = std::min(count, published->trending.size());
+    return std::vector<TrendingEntry>(published->trending.begin(), published->trending.begin() + n);
+}
+
+std::vector<int> TrendingTracker::recent(size_t count) const
+{
+    std::shared_ptr<const Snapshot> published = current();
+    const size_t n = std::min(count, published->recent.size());
+    return std::vector<int>(published->recent.begin(), published->recent.begin() + n);
+}
+
+// ==================== Helpers ====================
+
+void TrendingTracker::setScore(int postId, Entry& entry, double score)
+{
+    if (score == entry.score)
+        return;
+
+    byScore.erase(Key{ entry.score, entry.createdAt, postId });
+    entry.score = score;
+    byScore.insert(Key{ score, entry.createdAt, postId });
+}
+
+// Makes bucket the head, taking the points of every slot it reuses back
+// out of their posts' scores
+void TrendingTracker::expireBuckets(int64_t bucket)
+{
+    const int64_t slots = static_cast<int64_t>(buckets.size());
+    const int64_t first = std::max(headBucket + 1, bucket - slots + 1);
+
+    for (int64_t expired = first; expired <= bucket; ++expired) {
+        auto& slot = buckets[static_cast<size_t>(((expired % slots) + slots) % slots)];
+        for (const auto& [postId, points] : slot) {
+            auto it = posts.find(postId);
+            if (it != posts.end())
+                setScore(postId, it->second, it->second.score - points);
+        }
+        slot.clear();
+    }
+
+    headBucket = bucket;
+}
+
+// Called with the lock held after every update
+void TrendingTracker::changed()
+{
+    const uint64_t updated = version.fetch_add(1, std::memory_order_release) + 1;
+    if (updated - publishedVersion >= REPUBLISH_EVENTS)
+        publish();
+}
+
+// Rebuilds and swaps in the snapshot; the lock must be held
+std::shared_ptr<const TrendingTracker::Snapshot> TrendingTracker::publish() const
+{
+    auto rebuilt = std::make_shared<Snapshot>();
+    rebuilt->version = version.load(std::memory_order_relaxed);
+
+    // Decayed scores are shown relative to the newest event
+    const double now = static_cast<double>(latest) / options.halfLifeSeconds;
+    for (const Key& key : byScore) {
+        // Posts without points rank last and are not trending
+        const bool scored = windowed() ? key.score > 0.0 : key.score != NO_POINTS;
+        if (rebuilt->trending.size() == options.maxResults || !scored)
+            break;
+
+        const double score = windowed() ? key.score : std::exp2(key.score - now);
+        rebuilt->trending.push_back(TrendingEntry{ key.postId, score });
+    }
+
+    for (const Key& key : byCreation) {
+        if (rebuilt->recent.size() == options.maxResults)
+            break;
+        rebuilt->recent.push_back(key.postId);
+    }
+
+    publishedVersion = rebuilt->version;
+    std::shared_ptr<const Snapshot> published = rebuilt;
+    std::atomic_store(&snapshot, published);
+    return published;
+}
+
+// The published snapshot, rebuilt first when writers have moved on and
+// nobody holds the lock
+std::shared_ptr<const TrendingTracker::Snapshot> TrendingTracker::current() const
+{
+    std::shared_ptr<const Snapshot> published = std::atomic_load(&snapshot);
+    if (published->version == version.load(std::memory_order_acquire))
+        return published;
+
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock())
+        return published;
+
+    return publish();
+}